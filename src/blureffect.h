@@ -0,0 +1,78 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef BLUREFFECT_H
+#define BLUREFFECT_H
+
+#include <QImage>
+#include "breakbase.h"
+
+class BlurWidget;
+
+/**
+ * @class BlurEffect
+ * Covers every screen with a blurred and dimmed snapshot of what it showed
+ * when the break started, so the user keeps the context without being able
+ * to read or continue the work.
+ */
+class BlurEffect : public BreakBase
+{
+    Q_OBJECT
+
+public:
+    explicit BlurEffect( QObject *parent );
+    ~BlurEffect();
+    void activate() override;
+    void deactivate() override;
+    void prepare() override;
+    void release() override;
+
+private slots:
+    void slotScreenAdded( ScreenWidget* widget );
+
+private:
+    void capture( BlurWidget* widget );
+
+    ScreenWidgets* m_screens;
+    bool m_active;
+};
+
+class BlurWidget : public ScreenWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     * @param screen The screen to cover, followed when its geometry changes
+     * @param parent Parent Widget
+     */
+    explicit BlurWidget( QScreen* screen, QWidget *parent = 0 );
+
+    /**
+     * Shows @p snapshot, stretched over the whole screen. It is usually
+     * much smaller than the screen, the blur hides the upscaling.
+     */
+    void setSnapshot( const QImage& snapshot );
+
+protected:
+    void paintEvent( QPaintEvent* event ) override;
+
+private:
+    QImage m_snapshot;
+};
+
+#endif // BLUREFFECT_H
@@ -24,14 +24,14 @@
 
 #include <QApplication>
 #include <QDebug>
-#include <QDesktopWidget>
 #include <QObject>
 #include <QPainter>
 #include <QKeyEvent>
+#include <QScreen>
 
 
 BreakBase::BreakBase( QObject* parent )
-        : QObject( parent ),  m_grayEffectOnAllScreens( 0 ), m_readOnly( false ),
+        : QObject( parent ), m_grayLevel( 70 ), m_readOnly( false ),
         m_disableShortcut( false ), m_grayEffectOnAllScreensActivated( false )
 {
     m_breakControl = new BreakControl( 0, Qt::Popup );
@@ -40,18 +40,20 @@ BreakBase::BreakBase( QObject* parent )
     connect(m_breakControl, &BreakControl::skip, this, &BreakBase::skip);
     connect(m_breakControl, &BreakControl::lock, this, &BreakBase::lock);
     connect(m_breakControl, &BreakControl::postpone, this, &BreakBase::postpone);
+
+    // A screen added later may get the address of a removed one.
+    connect( qApp, &QGuiApplication::screenRemoved, this, &BreakBase::slotScreenRemoved );
 }
 
 BreakBase::~BreakBase()
 {
-    delete m_grayEffectOnAllScreens;
     delete m_breakControl;
 }
 
 void BreakBase::activate()
 {
     if ( m_grayEffectOnAllScreensActivated )
-        m_grayEffectOnAllScreens->activate();
+        m_grayEffectOnAllScreens->activate( m_grayLevel, m_grayExcludedScreens );
 
     m_breakControl->show();
     m_breakControl->setFocus();
@@ -75,6 +77,14 @@ void BreakBase::deactivate()
     m_breakControl->hide();
 }
 
+void BreakBase::prepare()
+{
+}
+
+void BreakBase::release()
+{
+}
+
 bool BreakBase::eventFilter( QObject *obj, QEvent *event )
 {
     if ( event->type() == QEvent::KeyPress ) {
@@ -134,43 +144,54 @@ void BreakBase::disableShortcut( bool disable )
 void BreakBase::setGrayEffectOnAllScreens( bool on )
 {
     m_grayEffectOnAllScreensActivated = on;
-    delete m_grayEffectOnAllScreens;
+    m_grayExcludedScreens.clear();
     if ( on ) {
-        m_grayEffectOnAllScreens = new GrayEffectOnAllScreens();
-        m_grayEffectOnAllScreens->setLevel( 70 );
+        if ( !m_grayEffectOnAllScreens )
+            m_grayEffectOnAllScreens = GrayEffectOnAllScreens::instance();
+    } else {
+        m_grayEffectOnAllScreens.clear();
     }
 }
 
 void BreakBase::setGrayEffectLevel( int level )
 {
-    m_grayEffectOnAllScreens->setLevel( level );
+    m_grayLevel = level;
+}
+
+void BreakBase::excludeGrayEffectOnScreen( QScreen* screen )
+{
+    m_grayExcludedScreens.insert( screen );
 }
 
-void BreakBase::excludeGrayEffectOnScreen( int screen )
+void BreakBase::slotScreenRemoved( QScreen* screen )
 {
-    m_grayEffectOnAllScreens->disable( screen );
+    m_grayExcludedScreens.remove( screen );
 }
 
 
 // ------------------------ GrayEffectOnAllScreens -------------//
 
-GrayEffectOnAllScreens::GrayEffectOnAllScreens()
+QSharedPointer<GrayEffectOnAllScreens> GrayEffectOnAllScreens::instance()
 {
-    for ( int i = 0; i < QApplication::desktop()->numScreens(); ++i ) {
-        GrayWidget* grayWidget = new GrayWidget( 0 );
-        m_widgets.insert( i, grayWidget );
+    // Weak, so the windows go away with the last effect using them.
+    static QWeakPointer<GrayEffectOnAllScreens> s_instance;
 
-        QRect rect = QApplication::desktop()->screenGeometry( i );
-        grayWidget->move( rect.topLeft() );
-        grayWidget->setGeometry( rect );
+    QSharedPointer<GrayEffectOnAllScreens> result = s_instance.toStrongRef();
+    if ( !result ) {
+        result = QSharedPointer<GrayEffectOnAllScreens>( new GrayEffectOnAllScreens() );
+        s_instance = result;
+    }
+    return result;
+}
 
-        KWindowSystem::forceActiveWindow( grayWidget->winId() );
-        KWindowSystem::setState( grayWidget->winId(), NET::KeepAbove );
-        KWindowSystem::setOnAllDesktops( grayWidget->winId(), true );
-        KWindowSystem::setState( grayWidget->winId(), NET::FullScreen );
+GrayEffectOnAllScreens::GrayEffectOnAllScreens()
+        : m_level( 70 ), m_active( false )
+{
+    foreach( QScreen* screen, QGuiApplication::screens() )
+        slotScreenAdded( screen );
 
-        qDebug() << "Created widget for screen" << i << "Position:" << rect.topLeft();
-    }
+    connect( qApp, &QGuiApplication::screenAdded, this, &GrayEffectOnAllScreens::slotScreenAdded );
+    connect( qApp, &QGuiApplication::screenRemoved, this, &GrayEffectOnAllScreens::slotScreenRemoved );
 }
 
 GrayEffectOnAllScreens::~GrayEffectOnAllScreens()
@@ -178,35 +199,59 @@ GrayEffectOnAllScreens::~GrayEffectOnAllScreens()
     qDeleteAll( m_widgets.values() );
 }
 
-void GrayEffectOnAllScreens::disable( int screen )
+void GrayEffectOnAllScreens::slotScreenAdded( QScreen* screen )
 {
-    qDebug() << "Removing widget from screen" << screen;
-    if ( !m_widgets.contains( screen ) )
-        return;
-
-    delete m_widgets.value( screen );
-    m_widgets.remove( screen );
+    GrayWidget* grayWidget = new GrayWidget( 0 );
+    m_widgets.insert( screen, grayWidget );
+
+    QRect rect = screen->geometry();
+    grayWidget->setGeometry( rect );
+    connect( screen, &QScreen::geometryChanged, grayWidget,
+             static_cast<void ( QWidget::* )( const QRect& )>( &QWidget::setGeometry ) );
+
+    // The hints are set on the unmapped window, so the window manager
+    // applies them right away when the overlay is shown.
+    KWindowSystem::setState( grayWidget->winId(), NET::KeepAbove );
+    KWindowSystem::setOnAllDesktops( grayWidget->winId(), true );
+    KWindowSystem::setState( grayWidget->winId(), NET::FullScreen );
+
+    qDebug() << "Created widget for screen" << screen->name() << "Position:" << rect.topLeft();
+
+    // A screen plugged in during a break is covered right away.
+    if ( m_active && !m_excluded.contains( screen ) ) {
+        grayWidget->setLevel( m_level );
+        grayWidget->show();
+    }
 }
 
-void GrayEffectOnAllScreens::activate()
+void GrayEffectOnAllScreens::slotScreenRemoved( QScreen* screen )
 {
-    foreach( GrayWidget* widget, m_widgets ) {
-        widget->show();
-        widget->update();
-    }
+    qDebug() << "Removing widget from screen" << screen->name();
+    delete m_widgets.take( screen );
+    m_excluded.remove( screen );
 }
 
-void GrayEffectOnAllScreens::deactivate()
+void GrayEffectOnAllScreens::activate( int level, const QSet<QScreen*>& excluded )
 {
-    foreach( GrayWidget* widget, m_widgets ) {
-        widget->hide();
+    m_active = true;
+    m_level = level;
+    m_excluded = excluded;
+
+    QHash<QScreen*,GrayWidget*>::const_iterator it = m_widgets.constBegin();
+    for ( ; it != m_widgets.constEnd(); ++it ) {
+        if ( excluded.contains( it.key() ) )
+            continue;
+
+        it.value()->setLevel( level );
+        it.value()->show();
     }
 }
 
-void GrayEffectOnAllScreens::setLevel( int val )
+void GrayEffectOnAllScreens::deactivate()
 {
+    m_active = false;
     foreach( GrayWidget* widget, m_widgets ) {
-        widget->setLevel( val );
+        widget->hide();
     }
 }
 
@@ -215,7 +260,7 @@ void GrayEffectOnAllScreens::setLevel( int val )
 
 
 GrayWidget::GrayWidget( QWidget *parent )
-        : QWidget( parent, Qt::Popup )
+        : QWidget( parent, Qt::Popup ), m_level( -1 )
 {
     setAutoFillBackground( false );
 }
@@ -233,6 +278,10 @@ bool GrayWidget::event( QEvent *event )
 
 void GrayWidget::setLevel( int val )
 {
+    if ( val == m_level )
+        return;
+    m_level = val;
+
     double level = 0;
     if ( val > 0 )
         level = ( double )val / 100;
@@ -241,3 +290,93 @@ void GrayWidget::setLevel( int val )
     setWindowOpacity( level );
     update();
 }
+
+
+//-------------------- ScreenWidget ----------------------------//
+
+
+ScreenWidget::ScreenWidget( QScreen* screen, QWidget *parent )
+        : QWidget( parent, Qt::Popup ), m_screen( screen )
+{
+    setAttribute( Qt::WA_OpaquePaintEvent );
+    slotDimension();
+    connect( screen, &QScreen::geometryChanged, this, &ScreenWidget::slotDimension );
+}
+
+void ScreenWidget::slotDimension()
+{
+    setGeometry( m_screen->geometry() );
+}
+
+
+//-------------------- ScreenWidgets ----------------------------//
+
+
+ScreenWidgets::ScreenWidgets( const Factory& factory, QObject* parent )
+        : QObject( parent ), m_factory( factory )
+{
+    connect( qApp, &QGuiApplication::screenAdded, this, &ScreenWidgets::slotScreenAdded );
+    connect( qApp, &QGuiApplication::screenRemoved, this, &ScreenWidgets::slotScreenRemoved );
+}
+
+ScreenWidgets::~ScreenWidgets()
+{
+    release();
+}
+
+ScreenWidget* ScreenWidgets::create( QScreen* screen )
+{
+    ScreenWidget* widget = m_factory( screen );
+    KWindowSystem::setOnAllDesktops( widget->winId(), true );
+    KWindowSystem::setState( widget->winId(), NET::KeepAbove );
+    KWindowSystem::setState( widget->winId(), NET::FullScreen );
+    m_widgets.append( widget );
+    return widget;
+}
+
+bool ScreenWidgets::prepare()
+{
+    if ( isPrepared() )
+        return false;
+
+    foreach( QScreen* screen, QGuiApplication::screens() )
+        create( screen );
+    return true;
+}
+
+void ScreenWidgets::release()
+{
+    qDeleteAll( m_widgets );
+    m_widgets.clear();
+}
+
+void ScreenWidgets::show()
+{
+    foreach( ScreenWidget* widget, m_widgets )
+        widget->show();
+}
+
+void ScreenWidgets::hide()
+{
+    foreach( ScreenWidget* widget, m_widgets )
+        widget->hide();
+}
+
+void ScreenWidgets::slotScreenAdded( QScreen* screen )
+{
+    // Only while prepared, otherwise prepare() picks the screen up.
+    if ( !isPrepared() )
+        return;
+
+    emit added( create( screen ) );
+}
+
+void ScreenWidgets::slotScreenRemoved( QScreen* screen )
+{
+    foreach( ScreenWidget* widget, m_widgets ) {
+        if ( widget->screen() == screen ) {
+            m_widgets.removeOne( widget );
+            delete widget;
+        }
+    }
+}
@@ -22,11 +22,17 @@
 
 #include <QObject>
 #include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
 #include <QWidget>
 
+#include <functional>
+
 class BreakControl;
 class GrayWidget;
 class GrayEffectOnAllScreens;
+class QScreen;
 
 class BreakBase : public QObject
 {
@@ -37,6 +43,19 @@ public:
     ~BreakBase();
     virtual void activate();
     virtual void deactivate();
+
+    /**
+     * Called a few seconds before a break is due, so the effect can load
+     * what it needs and activate() becomes cheap. The default does nothing.
+     */
+    virtual void prepare();
+
+    /**
+     * Frees what prepare() or activate() loaded, so nothing big is kept
+     * between breaks. The default does nothing.
+     */
+    virtual void release();
+
     virtual void setLabel( const QString& );
     void setReadOnly( bool );
     bool readOnly() const;
@@ -44,9 +63,15 @@ public:
     void showLock( bool );
     void showPostpone( bool );    
     void disableShortcut( bool disable );
+    /**
+     * Covers all screens with a gray overlay during the break. The overlay
+     * windows are shared by all effects and only created once.
+     */
     void setGrayEffectOnAllScreens( bool on );
     void setGrayEffectLevel( int level );
-    void excludeGrayEffectOnScreen( int screen );
+
+    /** Leaves @p screen uncovered, until the next setGrayEffectOnAllScreens(). */
+    void excludeGrayEffectOnScreen( QScreen* screen );
 
 protected:
     bool eventFilter( QObject *obj, QEvent *event ) override;
@@ -56,26 +81,57 @@ signals:
     void lock();
     void postpone();
 
+private slots:
+    void slotScreenRemoved( QScreen* screen );
+
 private:
     BreakControl* m_breakControl;
-    GrayEffectOnAllScreens* m_grayEffectOnAllScreens;
+    QSharedPointer<GrayEffectOnAllScreens> m_grayEffectOnAllScreens;
+    QSet<QScreen*> m_grayExcludedScreens;
+    int m_grayLevel;
     bool m_readOnly;
     bool m_disableShortcut;
     bool m_grayEffectOnAllScreensActivated;
 };
 
-class GrayEffectOnAllScreens
+/**
+ * @class GrayEffectOnAllScreens
+ * One overlay window per screen. The windows are created and given their
+ * window manager hints once, then only shown and hidden, so activating a
+ * break does not have to wait for new windows.
+ *
+ * Screens are tracked one by one: plugging in a monitor creates one
+ * window, unplugging deletes one and a resolution change only moves the
+ * window of that screen, also in the middle of a break.
+ */
+class GrayEffectOnAllScreens : public QObject
 {
+    Q_OBJECT
+
 public:
-    GrayEffectOnAllScreens();
+    /**
+     * @returns the overlays shared by all effects. They live as long as
+     * some effect holds on to them.
+     */
+    static QSharedPointer<GrayEffectOnAllScreens> instance();
+
     ~GrayEffectOnAllScreens();
-    void activate();
+
+    /** Shows the overlays, except on the screens in @p excluded. */
+    void activate( int level, const QSet<QScreen*>& excluded );
     void deactivate();
-    void setLevel( int val );
-    void disable( int screen );
+
+private slots:
+    void slotScreenAdded( QScreen* screen );
+    void slotScreenRemoved( QScreen* screen );
 
 private:
-    QHash<int,GrayWidget*> m_widgets;
+    GrayEffectOnAllScreens();
+
+    QHash<QScreen*,GrayWidget*> m_widgets;
+    QSet<QScreen*> m_excluded;
+    int m_level;
+    bool m_active;
 };
 
 class GrayWidget : public QWidget
@@ -92,6 +148,96 @@ public:
 
 protected:
     bool event( QEvent *event ) override;
+
+private:
+    int m_level;
+};
+
+/**
+ * @class ScreenWidget
+ * A window covering one screen, which follows the screen when its
+ * geometry changes. Subclasses paint every pixel, so the background is
+ * not filled first.
+ */
+class ScreenWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ScreenWidget( QScreen* screen, QWidget *parent = 0 );
+
+    QScreen* screen() const {
+        return m_screen;
+    }
+
+private slots:
+    void slotDimension();
+
+private:
+    QScreen* m_screen;
+};
+
+/**
+ * @class ScreenWidgets
+ * The windows of an effect that shows a widget of its own on every
+ * screen. They are created by prepare(), usually a few seconds before the
+ * break, and deleted again by release(). Screens plugged in or out in
+ * between get or lose their widget.
+ */
+class ScreenWidgets : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<ScreenWidget*( QScreen* )> Factory;
+
+    /** @param factory creates the widget for a screen. */
+    explicit ScreenWidgets( const Factory& factory, QObject* parent = 0 );
+    ~ScreenWidgets();
+
+    /**
+     * Creates a widget for every screen, unless they exist already.
+     * @returns whether widgets were created.
+     */
+    bool prepare();
+
+    /** Deletes all widgets. */
+    void release();
+
+    bool isPrepared() const {
+        return !m_widgets.isEmpty();
+    }
+
+    int count() const {
+        return m_widgets.count();
+    }
+
+    void show();
+    void hide();
+
+    /** @returns the widgets, as the type the factory creates. */
+    template<class T>
+    QVector<T*> widgets() const {
+        QVector<T*> widgets;
+        widgets.reserve( m_widgets.count() );
+        foreach( ScreenWidget* widget, m_widgets )
+            widgets.append( static_cast<T*>( widget ) );
+        return widgets;
+    }
+
+signals:
+    /** A screen was plugged in while prepared and got @p widget. */
+    void added( ScreenWidget* widget );
+
+private slots:
+    void slotScreenAdded( QScreen* screen );
+    void slotScreenRemoved( QScreen* screen );
+
+private:
+    ScreenWidget* create( QScreen* screen );
+
+    Factory m_factory;
+    QVector<ScreenWidget*> m_widgets;
 };
 
 #endif // BREAKBASE_H
@@ -20,11 +20,11 @@
 #include "breakcontrol.h"
 
 #include <QApplication>
-#include <QDesktopWidget>
 #include <QPainter>
 #include <QPaintEvent>
 #include <QLabel>
 #include <QPushButton>
+#include <QScreen>
 #include <QVBoxLayout>
 
 #include <QHBoxLayout>
@@ -69,17 +69,29 @@ BreakControl::BreakControl( QWidget* parent, Qt::WindowType type )
 
     setLayout( m_vbox );
 
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &BreakControl::slotCenterIt );
+    connect( qApp, &QGuiApplication::primaryScreenChanged, this, &BreakControl::slotPrimaryScreenChanged );
+
+    slotPrimaryScreenChanged( QGuiApplication::primaryScreen() );
+}
+
+void BreakControl::slotPrimaryScreenChanged( QScreen* screen )
+{
+    // Only the primary screen matters, other screens come and go unnoticed.
+    disconnect( m_screenConnection );
+    if ( screen )
+        m_screenConnection = connect( screen, &QScreen::geometryChanged, this, &BreakControl::slotCenterIt );
 
     slotCenterIt();
 }
 
 void BreakControl::slotCenterIt()
 {
-    const QRect r( QApplication::desktop()->screenGeometry(
-                       QApplication::desktop()->primaryScreen() ) );
+    const QScreen* screen = QGuiApplication::primaryScreen();
+    if ( !screen )
+        return;
 
-    const QPoint center( r.width() / 2 - sizeHint().width() / 2, r.y() );
+    const QRect r( screen->geometry() );
+    const QPoint center( r.x() + r.width() / 2 - sizeHint().width() / 2, r.y() );
     move( center );
 }
 
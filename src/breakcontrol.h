@@ -23,6 +23,7 @@
 #include <QWidget>
 
 class QLabel;
+class QScreen;
 class QPushButton;
 class QVBoxLayout;
 
@@ -42,6 +43,7 @@ protected:
 
 private slots:
     void slotCenterIt();
+    void slotPrimaryScreenChanged( QScreen* screen );
     void slotLock();
 
 signals:
@@ -55,6 +57,7 @@ private:
     QPushButton* m_lockButton;
     QVBoxLayout* m_vbox;
     QPushButton* m_postponeButton;
+    QMetaObject::Connection m_screenConnection;
 };
 
 #endif // BREAKCONTROL_H
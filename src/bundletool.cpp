@@ -0,0 +1,195 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/*
+   rsibreak-bundle packs a folder of images into a single bundle file for
+   the slide show effect. Images are scaled to the target screen size and
+   encoded in parallel, then appended to the bundle in a stable order.
+*/
+
+#include "imagebundle.h"
+#include "imagescaler.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QImage>
+#include <QImageReader>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <stdio.h>
+
+struct EncodeSettings {
+    QSize size;
+    bool expand;
+    int quality;
+};
+
+struct EncodedImage {
+    QString name;
+    QByteArray data;
+    QSize size;
+};
+
+static QStringList findImages( const QString& folder, bool recursive )
+{
+    QStringList filters;
+    foreach( const QByteArray& format, QImageReader::supportedImageFormats() ) {
+        filters << "*." + QString::fromLatin1( format );
+        filters << "*." + QString::fromLatin1( format ).toUpper();
+    }
+
+    QStringList files;
+    QDirIterator it( folder, filters, QDir::Files | QDir::NoSymLinks,
+                     recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags );
+    while ( it.hasNext() )
+        files << it.next();
+
+    // A stable order makes rebuilt bundles comparable.
+    files.sort();
+    return files;
+}
+
+static EncodedImage encode( const QString& name, const EncodeSettings& settings )
+{
+    EncodedImage result;
+    result.name = name;
+
+    QImage image( name );
+    if ( image.isNull() )
+        return result;
+
+    // Only scale down, small images are kept as they are so the slide show
+    // can still decide to skip them.
+    if ( image.width() > settings.size.width() || image.height() > settings.size.height() ) {
+        const Qt::AspectRatioMode mode = settings.expand ? Qt::KeepAspectRatioByExpanding
+                                                         : Qt::KeepAspectRatio;
+        image = ImageScaler::scaled( image, image.size().scaled( settings.size, mode ) );
+    }
+
+    QBuffer buffer( &result.data );
+    buffer.open( QIODevice::WriteOnly );
+    const bool alpha = image.hasAlphaChannel();
+    if ( !image.save( &buffer, alpha ? "PNG" : "JPEG", alpha ? -1 : settings.quality ) ) {
+        result.data.clear();
+        return result;
+    }
+
+    result.size = image.size();
+    return result;
+}
+
+// Functor for QtConcurrent, which needs result_type to deduce the result.
+struct Encoder {
+    typedef EncodedImage result_type;
+
+    explicit Encoder( const EncodeSettings& settings ) : m_settings( settings ) {}
+
+    EncodedImage operator()( const QString& name ) const {
+        return encode( name, m_settings );
+    }
+
+    EncodeSettings m_settings;
+};
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+    app.setApplicationName( "rsibreak-bundle" );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Packs a folder of images into a bundle for the RSIBreak slide show." );
+    parser.addHelpOption();
+    parser.addOption( QCommandLineOption( QStringList() << "s" << "size",
+                                          "Target screen size, defaults to 1920x1080.", "WxH", "1920x1080" ) );
+    parser.addOption( QCommandLineOption( QStringList() << "e" << "expand",
+                                          "Scale images to cover the whole screen." ) );
+    parser.addOption( QCommandLineOption( QStringList() << "q" << "quality",
+                                          "JPEG quality, 0-100.", "quality", "90" ) );
+    parser.addOption( QCommandLineOption( QStringList() << "r" << "recursive",
+                                          "Search the folders recursively." ) );
+    parser.addOption( QCommandLineOption( QStringList() << "j" << "jobs",
+                                          "Number of parallel encoders.", "jobs",
+                                          QString::number( QThread::idealThreadCount() ) ) );
+    parser.addPositionalArgument( "bundle", "The bundle file to write, usually ending in .rsibundle." );
+    parser.addPositionalArgument( "folders", "Folders to take images from.", "folders..." );
+    parser.process( app );
+
+    QTextStream err( stderr );
+    const QStringList args = parser.positionalArguments();
+    if ( args.count() < 2 )
+        parser.showHelp( 1 );
+
+    EncodeSettings settings;
+    settings.expand = parser.isSet( "expand" );
+    settings.quality = qBound( 0, parser.value( "quality" ).toInt(), 100 );
+    const QStringList size = parser.value( "size" ).split( 'x' );
+    if ( size.count() == 2 )
+        settings.size = QSize( size[0].toInt(), size[1].toInt() );
+    if ( !settings.size.isValid() || settings.size.isEmpty() ) {
+        err << "Invalid size: " << parser.value( "size" ) << endl;
+        return 1;
+    }
+
+    QStringList files;
+    for ( int i = 1; i < args.count(); ++i )
+        files << findImages( args[i], parser.isSet( "recursive" ) );
+
+    if ( files.isEmpty() ) {
+        err << "No images found." << endl;
+        return 1;
+    }
+
+    ImageBundleWriter writer;
+    if ( !writer.open( args[0] ) )
+        return 1;
+
+    const int jobs = qMax( 1, parser.value( "jobs" ).toInt() );
+    QThreadPool::globalInstance()->setMaxThreadCount( jobs );
+
+    // Encode in batches so memory stays bounded for large collections
+    // while the results are still written in a stable order.
+    const int batchSize = jobs * 4;
+    for ( int first = 0; first < files.count(); first += batchSize ) {
+        const QStringList batch = files.mid( first, batchSize );
+        const QList<EncodedImage> encoded =
+            QtConcurrent::blockingMapped<QList<EncodedImage> >( batch, Encoder( settings ) );
+
+        foreach( const EncodedImage& image, encoded ) {
+            if ( image.data.isEmpty() ) {
+                err << "Skipping unreadable image " << image.name << endl;
+                continue;
+            }
+            if ( !writer.add( image.data, image.size ) ) {
+                err << "Could not write " << image.name << endl;
+                return 1;
+            }
+        }
+        err << qMin( first + batchSize, files.count() ) << "/" << files.count() << "\r" << flush;
+    }
+
+    if ( !writer.finish() ) {
+        err << "Could not finish " << args[0] << endl;
+        return 1;
+    }
+
+    err << endl << "Wrote " << writer.count() << " images to " << args[0] << endl;
+    return 0;
+}
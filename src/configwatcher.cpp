@@ -0,0 +1,126 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "configwatcher.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <KConfig>
+
+namespace
+{
+
+// Runs on the thread pool, KConfig is reentrant.
+RSIConfig readFile( const QString& fileName )
+{
+    KConfig config( fileName );
+    return RSIConfig::read( config );
+}
+
+}
+
+ConfigWatcher::ConfigWatcher( const QString& fileName, QObject* parent )
+        : QObject( parent )
+        , m_fileName( fileName )
+        , m_readAgain( false )
+{
+    qRegisterMetaType<RSIConfig>();
+
+    const QFileInfo info( fileName );
+    if ( info.isAbsolute() )
+        m_directories << info.absolutePath();
+    else
+        m_directories = QStandardPaths::standardLocations( QStandardPaths::GenericConfigLocation );
+
+    m_settleTimer.setSingleShot( true );
+    m_settleTimer.setInterval( SETTLE_DELAY );
+
+    connect( &m_watcher, &QFileSystemWatcher::fileChanged, this, &ConfigWatcher::slotFileChanged );
+    connect( &m_watcher, &QFileSystemWatcher::directoryChanged, this, &ConfigWatcher::slotDirectoryChanged );
+    connect( &m_settleTimer, &QTimer::timeout, this, &ConfigWatcher::slotRead );
+    connect( &m_reader, &QFutureWatcher<RSIConfig>::finished, this, &ConfigWatcher::slotReadFinished );
+
+    watch();
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+    m_reader.waitForFinished();
+}
+
+QStringList ConfigWatcher::files() const
+{
+    return m_watcher.files();
+}
+
+bool ConfigWatcher::watch()
+{
+    bool changed = false;
+    for ( const QString& directory : m_directories ) {
+        if ( !QFileInfo::exists( directory ) )
+            continue;
+        if ( !m_watcher.directories().contains( directory ) )
+            m_watcher.addPath( directory );
+
+        const QFileInfo info( QDir( directory ).filePath( QFileInfo( m_fileName ).fileName() ) );
+        const QDateTime stamp = info.exists() ? info.lastModified() : QDateTime();
+        if ( m_stamps.value( info.filePath() ) != stamp ) {
+            m_stamps.insert( info.filePath(), stamp );
+            changed = true;
+        }
+
+        // A file replaced by a rename is no longer watched, add it again.
+        if ( info.exists() && !m_watcher.files().contains( info.filePath() ) )
+            m_watcher.addPath( info.filePath() );
+    }
+    return changed;
+}
+
+void ConfigWatcher::slotFileChanged()
+{
+    watch();
+    m_settleTimer.start();
+}
+
+void ConfigWatcher::slotDirectoryChanged()
+{
+    // Other applications write to the same directory, only react when
+    // our file is affected.
+    if ( watch() )
+        m_settleTimer.start();
+}
+
+void ConfigWatcher::slotRead()
+{
+    if ( m_reader.isRunning() ) {
+        m_readAgain = true;
+        return;
+    }
+    m_reader.setFuture( QtConcurrent::run( readFile, m_fileName ) );
+}
+
+void ConfigWatcher::slotReadFinished()
+{
+    emit configRead( m_reader.result() );
+
+    if ( m_readAgain ) {
+        m_readAgain = false;
+        slotRead();
+    }
+}
@@ -0,0 +1,84 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_CONFIGWATCHER_H
+#define RSIBREAK_CONFIGWATCHER_H
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include "rsiconfig.h"
+
+/**
+ * @class ConfigWatcher
+ * Notices when rsibreakrc is changed behind RSIBreak's back, by hand, by
+ * another instance or by an administrator in /etc/xdg, and reads it again.
+ *
+ * The file is watched in every configuration directory, together with the
+ * directories themselves, so files that are created later or replaced by
+ * a rename are picked up as well. Changes are collected for a short while,
+ * editors tend to write in several steps, and then parsed on the global
+ * thread pool, so the GUI thread only has to apply the result.
+ */
+class ConfigWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Milliseconds to wait for more changes before reading the file. */
+    static const int SETTLE_DELAY = 300;
+
+    /**
+     * Watches @p fileName in all configuration directories. An absolute
+     * path watches just that file, as tests do.
+     */
+    explicit ConfigWatcher( const QString& fileName, QObject* parent = 0 );
+    ~ConfigWatcher();
+
+    /** @returns the existing files that are watched. */
+    QStringList files() const;
+
+signals:
+    /** The file changed and was read again into @p config. */
+    void configRead( const RSIConfig& config );
+
+private slots:
+    void slotFileChanged();
+    void slotDirectoryChanged();
+    void slotRead();
+    void slotReadFinished();
+
+private:
+    // Watches what exists now, returns whether any file appeared,
+    // disappeared or was modified since the last call.
+    bool watch();
+
+    QString m_fileName;
+    QStringList m_directories;
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QDateTime> m_stamps;
+    QTimer m_settleTimer;
+    QFutureWatcher<RSIConfig> m_reader;
+    // A change arrived while the file was being read.
+    bool m_readAgain;
+};
+
+#endif // RSIBREAK_CONFIGWATCHER_H
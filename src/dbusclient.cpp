@@ -0,0 +1,119 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "dbusclient.h"
+
+#include <QCoreApplication>
+#include <QDBusAbstractInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QDebug>
+
+namespace
+{
+
+// QDBusAbstractInterface, unlike QDBusInterface, does not introspect.
+class DBusProxy : public QDBusAbstractInterface
+{
+public:
+    DBusProxy( const QString& service, const QString& path, const char* interface,
+               const QDBusConnection& connection, QObject* parent )
+        : QDBusAbstractInterface( service, path, interface, connection, parent ) {}
+};
+
+}
+
+DBusClient* DBusClient::instance()
+{
+    static DBusClient* s_instance = nullptr;
+    if ( !s_instance )
+        s_instance = new DBusClient( QDBusConnection::sessionBus(), QString(), QString(), qApp );
+    return s_instance;
+}
+
+DBusClient::DBusClient( const QDBusConnection& connection, const QString& screenSaverService,
+                        const QString& plasmaShellService, QObject* parent )
+    : QObject( parent ), m_timeout( DEFAULT_TIMEOUT )
+{
+    m_proxies[ScreenSaver] = new DBusProxy(
+        screenSaverService.isEmpty() ? QString( "org.freedesktop.ScreenSaver" ) : screenSaverService,
+        "/ScreenSaver", "org.freedesktop.ScreenSaver", connection, this );
+    connection.connect( m_proxies[ScreenSaver]->service(), "/ScreenSaver", "org.freedesktop.ScreenSaver",
+                        "ActiveChanged", this, SIGNAL( screenLockChanged( bool ) ) );
+    // A crashed screen saver takes its lock with it, a restarted one is
+    // asked again.
+    QDBusServiceWatcher* services = new QDBusServiceWatcher( this );
+    services->setConnection( connection );
+    services->addWatchedService( m_proxies[ScreenSaver]->service() );
+    connect( services, &QDBusServiceWatcher::serviceRegistered, this, &DBusClient::queryScreenLock );
+    connect( services, &QDBusServiceWatcher::serviceUnregistered, this, [this]() {
+        emit screenLockChanged( false );
+    } );
+    m_proxies[PlasmaShell] = new DBusProxy(
+        plasmaShellService.isEmpty() ? QString( "org.kde.plasmashell" ) : plasmaShellService,
+        "/PlasmaShell", "org.kde.PlasmaShell", connection, this );
+
+    setTimeout( m_timeout );
+}
+
+void DBusClient::setTimeout( int msecs )
+{
+    m_timeout = msecs;
+    for ( int i = 0; i < ServiceCount; ++i )
+        m_proxies[i]->setTimeout( msecs );
+}
+
+QDBusPendingCall DBusClient::asyncCall( Service service, const QString& method,
+                                        const QList<QVariant>& args )
+{
+    QDBusPendingCall call = m_proxies[service]->asyncCallWithArgumentList( method, args );
+
+    QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher( call, this );
+    connect( watcher, &QDBusPendingCallWatcher::finished, this, [this, method]( QDBusPendingCallWatcher * w ) {
+        if ( w->isError() ) {
+            qWarning() << method << w->error().name() << w->error().message();
+            emit failed( method, w->error().name() );
+        } else {
+            emit finished( method );
+        }
+        w->deleteLater();
+    } );
+
+    return call;
+}
+
+void DBusClient::lockScreen()
+{
+    asyncCall( ScreenSaver, QStringLiteral( "Lock" ) );
+}
+
+void DBusClient::queryScreenLock()
+{
+    QDBusPendingCallWatcher* watcher =
+        new QDBusPendingCallWatcher( asyncCall( ScreenSaver, QStringLiteral( "GetActive" ) ), this );
+    connect( watcher, &QDBusPendingCallWatcher::finished, this, [this]( QDBusPendingCallWatcher * w ) {
+        QDBusPendingReply<bool> reply = *w;
+        if ( !reply.isError() )
+            emit screenLockChanged( reply.value() );
+        w->deleteLater();
+    } );
+}
+
+void DBusClient::setDashboardShown( bool shown )
+{
+    asyncCall( PlasmaShell, QStringLiteral( "setDashboardShown" ), QList<QVariant>() << shown );
+}
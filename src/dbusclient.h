@@ -0,0 +1,102 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_DBUSCLIENT_H
+#define RSIBREAK_DBUSCLIENT_H
+
+#include <QDBusConnection>
+#include <QDBusPendingCall>
+#include <QObject>
+#include <QVariant>
+
+class QDBusAbstractInterface;
+
+/**
+ * @class DBusClient
+ * Talks to the desktop services RSIBreak depends on, the screen saver and
+ * the Plasma shell, without ever blocking the GUI thread.
+ *
+ * The proxies are created once and never introspect the remote side, calls
+ * are sent asynchronously and fail after a timeout instead of hanging the
+ * break screen when a service is slow.
+ */
+class DBusClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Service {
+        ScreenSaver = 0,
+        PlasmaShell,
+        ServiceCount
+    };
+
+    static const int DEFAULT_TIMEOUT = 2000;
+
+    /** @returns the client on the session bus, shared by the whole application. */
+    static DBusClient* instance();
+
+    /**
+     * Creates a client for @p connection. Empty service names use the
+     * well known names, tests pass the name of a mock service instead.
+     */
+    explicit DBusClient( const QDBusConnection& connection,
+                         const QString& screenSaverService = QString(),
+                         const QString& plasmaShellService = QString(),
+                         QObject* parent = 0 );
+
+    /** Locks the screen through org.freedesktop.ScreenSaver. */
+    void lockScreen();
+
+    /**
+     * Asks the screen saver whether the screen is locked, the answer comes
+     * as screenLockChanged(). Later changes come by themselves, a screen
+     * saver that goes away counts as unlocked.
+     */
+    void queryScreenLock();
+
+    /** Shows or hides the Plasma dashboard. */
+    void setDashboardShown( bool shown );
+
+    /**
+     * Calls @p method of @p service asynchronously. Errors and timeouts are
+     * reported by failed(), the caller may watch the returned call as well.
+     */
+    QDBusPendingCall asyncCall( Service service, const QString& method,
+                                const QList<QVariant>& args = QList<QVariant>() );
+
+    /** @returns the timeout of calls, in milliseconds. */
+    int timeout() const {
+        return m_timeout;
+    }
+    void setTimeout( int msecs );
+
+signals:
+    /** A call of @p method returned successfully. */
+    void finished( const QString& method );
+
+    /** A call of @p method failed or timed out. */
+    void failed( const QString& method, const QString& error );
+
+    /** The screen saver started or stopped, which locks the screen. */
+    void screenLockChanged( bool locked );
+
+private:
+    QDBusAbstractInterface* m_proxies[ServiceCount];
+    int m_timeout;
+};
+
+#endif // RSIBREAK_DBUSCLIENT_H
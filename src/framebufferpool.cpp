@@ -0,0 +1,61 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "framebufferpool.h"
+
+FrameBufferPool::FrameBufferPool( int count, QImage::Format format )
+    : m_buffers( qMax( 1, count ) )
+    , m_format( format )
+    , m_next( 0 )
+    , m_allocations( 0 )
+{
+}
+
+QImage* FrameBufferPool::acquire( const QSize& size )
+{
+    if ( size != m_size ) {
+        clear();
+        m_size = size;
+    }
+
+    QImage* buffer = &m_buffers[m_next];
+
+    if ( buffer->isNull() && !m_size.isEmpty() ) {
+        *buffer = QImage( m_size, m_format );
+        ++m_allocations;
+    }
+
+    return buffer;
+}
+
+void FrameBufferPool::present( const QImage* buffer )
+{
+    for ( int i = 0; i < m_buffers.count(); ++i ) {
+        if ( &m_buffers.at( i ) == buffer ) {
+            m_next = ( i + 1 ) % m_buffers.count();
+            return;
+        }
+    }
+}
+
+void FrameBufferPool::clear()
+{
+    for ( int i = 0; i < m_buffers.count(); ++i )
+        m_buffers[i] = QImage();
+
+    m_size = QSize();
+    m_next = 0;
+}
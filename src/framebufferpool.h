@@ -0,0 +1,69 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef RSIBREAK_FRAMEBUFFERPOOL_H
+#define RSIBREAK_FRAMEBUFFERPOOL_H
+
+#include <QImage>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @class FrameBufferPool
+ * A small ring of screen sized images that are rendered into and shown in
+ * turn. The buffers are allocated on first use and then recycled, so once
+ * warmed up showing a new frame does not allocate anything.
+ *
+ * The pool owns the images. Callers keep pointers, never QImage copies,
+ * otherwise painting into a buffer would detach it and allocate again.
+ */
+class FrameBufferPool
+{
+public:
+    /**
+     * @param count Number of buffers. Two are enough for one being shown
+     * while the next is rendered.
+     */
+    explicit FrameBufferPool( int count = 2, QImage::Format format = QImage::Format_RGB32 );
+
+    /**
+     * @returns the next buffer in the ring, of size @p size. All buffers
+     * are dropped when the size changes, for example after a resolution
+     * switch. The ring only moves on in present(), so until then the same
+     * buffer is returned again and the one on screen is never painted into.
+     */
+    QImage* acquire( const QSize& size );
+
+    /** @p buffer, returned by acquire(), is shown now. */
+    void present( const QImage* buffer );
+
+    /** Frees all buffers. Pointers handed out before become invalid. */
+    void clear();
+
+    /** @returns how many buffers were allocated over the pool's lifetime. */
+    int allocations() const {
+        return m_allocations;
+    }
+
+private:
+    QVector<QImage> m_buffers;
+    QImage::Format m_format;
+    QSize m_size;
+    int m_next;
+    int m_allocations;
+};
+
+#endif // RSIBREAK_FRAMEBUFFERPOOL_H
@@ -0,0 +1,325 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "imageblur.h"
+#include "imagekernels.h"
+
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <vector>
+
+namespace
+{
+
+// Three box passes are close enough to a Gaussian.
+const int PASSES = 3;
+
+// Width of the column strips of the vertical pass, a multiple of 8.
+const int STRIP_PIXELS = 64;
+
+// Box blurs one row of @p width pixels from @p in into @p out.
+typedef void ( *RowKernel )( const quint32* in, quint32* out, int width, int radius, float scale );
+
+// Writes the running column sums to @p out, then moves the window down a row.
+typedef void ( *ColumnKernel )( qint32* sums, const quint32* add, const quint32* sub,
+                                quint32* out, int pixels, float scale );
+
+inline int clampIndex( int i, int size )
+{
+    return qBound( 0, i, size - 1 );
+}
+
+void rowScalar( const quint32* in, quint32* out, int width, int radius, float scale )
+{
+    const uchar* p = reinterpret_cast<const uchar*>( in );
+    uchar* o = reinterpret_cast<uchar*>( out );
+
+    int sum[4] = { 0, 0, 0, 0 };
+    for ( int i = -radius; i <= radius; ++i ) {
+        const uchar* q = p + clampIndex( i, width ) * 4;
+        for ( int ch = 0; ch < 4; ++ch )
+            sum[ch] += q[ch];
+    }
+
+    for ( int x = 0; x < width; ++x ) {
+        const uchar* add = p + clampIndex( x + radius + 1, width ) * 4;
+        const uchar* sub = p + clampIndex( x - radius, width ) * 4;
+        for ( int ch = 0; ch < 4; ++ch ) {
+            o[x * 4 + ch] = uchar( qMin( 255, int( sum[ch] * scale + 0.5f ) ) );
+            sum[ch] += add[ch] - sub[ch];
+        }
+    }
+}
+
+void columnScalar( qint32* sums, const quint32* add, const quint32* sub,
+                   quint32* out, int pixels, float scale )
+{
+    const uchar* a = reinterpret_cast<const uchar*>( add );
+    const uchar* s = reinterpret_cast<const uchar*>( sub );
+    uchar* o = reinterpret_cast<uchar*>( out );
+
+    for ( int i = 0; i < pixels * 4; ++i ) {
+        o[i] = uchar( qMin( 255, int( sums[i] * scale + 0.5f ) ) );
+        sums[i] += a[i] - s[i];
+    }
+}
+
+#ifdef RSIBREAK_HAVE_SSE2
+inline __m128i loadPixel( const quint32* p )
+{
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( *p ), zero ), zero );
+}
+
+void rowSSE2( const quint32* in, quint32* out, int width, int radius, float scale )
+{
+    const __m128 s = _mm_set1_ps( scale );
+
+    // All four channels of a pixel are summed in one register.
+    __m128i sum = _mm_setzero_si128();
+    for ( int i = -radius; i <= radius; ++i )
+        sum = _mm_add_epi32( sum, loadPixel( in + clampIndex( i, width ) ) );
+
+    for ( int x = 0; x < width; ++x ) {
+        __m128i v = _mm_cvtps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( sum ), s ) );
+        v = _mm_packs_epi32( v, v );
+        v = _mm_packus_epi16( v, v );
+        out[x] = _mm_cvtsi128_si32( v );
+
+        const __m128i add = loadPixel( in + clampIndex( x + radius + 1, width ) );
+        const __m128i sub = loadPixel( in + clampIndex( x - radius, width ) );
+        sum = _mm_add_epi32( sum, _mm_sub_epi32( add, sub ) );
+    }
+}
+
+void columnSSE2( qint32* sums, const quint32* add, const quint32* sub,
+                 quint32* out, int pixels, float scale )
+{
+    const __m128 s = _mm_set1_ps( scale );
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for ( ; i + 4 <= pixels; i += 4 ) {
+        __m128i* sum = reinterpret_cast<__m128i*>( sums + i * 4 );
+
+        __m128i v[4];
+        for ( int k = 0; k < 4; ++k )
+            v[k] = _mm_cvtps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( sum + k ) ), s ) );
+        const __m128i packed = _mm_packus_epi16( _mm_packs_epi32( v[0], v[1] ), _mm_packs_epi32( v[2], v[3] ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( out + i ), packed );
+
+        const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( add + i ) );
+        const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sub + i ) );
+        const __m128i a16[2] = { _mm_unpacklo_epi8( a, zero ), _mm_unpackhi_epi8( a, zero ) };
+        const __m128i b16[2] = { _mm_unpacklo_epi8( b, zero ), _mm_unpackhi_epi8( b, zero ) };
+        for ( int k = 0; k < 4; ++k ) {
+            const __m128i a32 = ( k & 1 ) ? _mm_unpackhi_epi16( a16[k / 2], zero ) : _mm_unpacklo_epi16( a16[k / 2], zero );
+            const __m128i b32 = ( k & 1 ) ? _mm_unpackhi_epi16( b16[k / 2], zero ) : _mm_unpacklo_epi16( b16[k / 2], zero );
+            _mm_storeu_si128( sum + k, _mm_add_epi32( _mm_loadu_si128( sum + k ), _mm_sub_epi32( a32, b32 ) ) );
+        }
+    }
+
+    columnScalar( sums + i * 4, add + i, sub + i, out + i, pixels - i, scale );
+}
+#endif
+
+#if defined(RSIBREAK_HAVE_AVX2) && defined(RSIBREAK_HAVE_SSE2)
+__attribute__(( target( "avx2" ) ))
+void columnAVX2( qint32* sums, const quint32* add, const quint32* sub,
+                 quint32* out, int pixels, float scale )
+{
+    const __m256 s = _mm256_set1_ps( scale );
+    // Undoes the lane interleaving of the two pack instructions.
+    const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+
+    int i = 0;
+    for ( ; i + 8 <= pixels; i += 8 ) {
+        __m256i* sum = reinterpret_cast<__m256i*>( sums + i * 4 );
+
+        // Two pixels, eight channels, per register.
+        __m256i v[4];
+        for ( int k = 0; k < 4; ++k )
+            v[k] = _mm256_cvtps_epi32( _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_loadu_si256( sum + k ) ), s ) );
+        __m256i packed = _mm256_packus_epi16( _mm256_packs_epi32( v[0], v[1] ), _mm256_packs_epi32( v[2], v[3] ) );
+        packed = _mm256_permutevar8x32_epi32( packed, order );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + i ), packed );
+
+        for ( int k = 0; k < 4; ++k ) {
+            const __m128i a = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( add + i + k * 2 ) );
+            const __m128i b = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( sub + i + k * 2 ) );
+            const __m256i delta = _mm256_sub_epi32( _mm256_cvtepu8_epi32( a ), _mm256_cvtepu8_epi32( b ) );
+            _mm256_storeu_si256( sum + k, _mm256_add_epi32( _mm256_loadu_si256( sum + k ), delta ) );
+        }
+    }
+
+    columnScalar( sums + i * 4, add + i, sub + i, out + i, pixels - i, scale );
+}
+#endif
+
+struct Pass {
+    const uchar* src;
+    int srcBytesPerLine;
+    uchar* dst;
+    int dstBytesPerLine;
+    int width;
+    int height;
+    int radius;
+    float scale;
+    RowKernel row;
+    ColumnKernel column;
+};
+
+struct Range {
+    int first;
+    int last;
+};
+
+inline const quint32* line( const Pass& pass, int y )
+{
+    return reinterpret_cast<const quint32*>( pass.src + qptrdiff( y ) * pass.srcBytesPerLine );
+}
+
+void blurRows( const Pass& pass, const Range& rows )
+{
+    for ( int y = rows.first; y < rows.last; ++y ) {
+        quint32* out = reinterpret_cast<quint32*>( pass.dst + qptrdiff( y ) * pass.dstBytesPerLine );
+        pass.row( line( pass, y ), out, pass.width, pass.radius, pass.scale );
+    }
+}
+
+void blurColumns( const Pass& pass, const Range& columns )
+{
+    // Reused, so the strips of a pass do not allocate.
+    thread_local std::vector<qint32> sums;
+    const int pixels = columns.last - columns.first;
+    sums.assign( pixels * 4, 0 );
+
+    for ( int i = -pass.radius; i <= pass.radius; ++i ) {
+        const uchar* p = reinterpret_cast<const uchar*>( line( pass, clampIndex( i, pass.height ) ) + columns.first );
+        for ( int k = 0; k < pixels * 4; ++k )
+            sums[k] += p[k];
+    }
+
+    for ( int y = 0; y < pass.height; ++y ) {
+        quint32* out = reinterpret_cast<quint32*>( pass.dst + qptrdiff( y ) * pass.dstBytesPerLine );
+        pass.column( sums.data(),
+                     line( pass, clampIndex( y + pass.radius + 1, pass.height ) ) + columns.first,
+                     line( pass, clampIndex( y - pass.radius, pass.height ) ) + columns.first,
+                     out + columns.first, pixels, pass.scale );
+    }
+}
+
+// Functors for QtConcurrent::blockingMap.
+struct RowBlur {
+    typedef void result_type;
+
+    explicit RowBlur( const Pass& pass ) : m_pass( pass ) {}
+
+    void operator()( const Range& rows ) const {
+        blurRows( m_pass, rows );
+    }
+
+    const Pass& m_pass;
+};
+
+struct ColumnBlur {
+    typedef void result_type;
+
+    explicit ColumnBlur( const Pass& pass ) : m_pass( pass ) {}
+
+    void operator()( const Range& columns ) const {
+        blurColumns( m_pass, columns );
+    }
+
+    const Pass& m_pass;
+};
+
+QVector<Range> split( int count, int parts, int grain )
+{
+    QVector<Range> ranges;
+    const int step = qMax( grain, ( ( count + parts - 1 ) / parts + grain - 1 ) / grain * grain );
+    for ( int first = 0; first < count; first += step ) {
+        Range range = { first, qMin( count, first + step ) };
+        ranges.append( range );
+    }
+    return ranges;
+}
+
+}
+
+void ImageBlur::blur( QImage* image, int radius, ImageScaler::Kernel kernel )
+{
+    if ( !image || image->isNull() || radius < 1 )
+        return;
+
+    if ( image->format() != QImage::Format_RGB32 &&
+            image->format() != QImage::Format_ARGB32_Premultiplied )
+        *image = image->convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+    if ( kernel == ImageScaler::Auto || !ImageScaler::isSupported( kernel ) )
+        kernel = ImageScaler::bestKernel();
+
+    QImage tmp( image->size(), image->format() );
+
+    // Detach a shared image first, all passes must work on the same pixels.
+    uchar* bits = image->bits();
+
+    Pass horizontal;
+    horizontal.src = bits;
+    horizontal.srcBytesPerLine = image->bytesPerLine();
+    horizontal.dst = tmp.bits();
+    horizontal.dstBytesPerLine = tmp.bytesPerLine();
+    horizontal.width = image->width();
+    horizontal.height = image->height();
+    horizontal.radius = radius;
+    horizontal.scale = 1.0f / ( 2 * radius + 1 );
+    horizontal.row = rowScalar;
+    horizontal.column = columnScalar;
+#ifdef RSIBREAK_HAVE_SSE2
+    if ( kernel == ImageScaler::SSE2 || kernel == ImageScaler::AVX2 ) {
+        horizontal.row = rowSSE2;
+        horizontal.column = columnSSE2;
+    }
+#endif
+#if defined(RSIBREAK_HAVE_AVX2) && defined(RSIBREAK_HAVE_SSE2)
+    if ( kernel == ImageScaler::AVX2 )
+        horizontal.column = columnAVX2;
+#endif
+
+    // The vertical pass reads what the horizontal one wrote, back into the image.
+    Pass vertical = horizontal;
+    vertical.src = tmp.constBits();
+    vertical.srcBytesPerLine = tmp.bytesPerLine();
+    vertical.dst = bits;
+    vertical.dstBytesPerLine = image->bytesPerLine();
+
+    const bool parallel = image->width() * image->height() >= ImageKernels::PARALLEL_THRESHOLD;
+    const int parts = parallel ? QThread::idealThreadCount() * 4 : 1;
+    QVector<Range> rows = split( image->height(), parts, 1 );
+    QVector<Range> columns = split( image->width(), parts, STRIP_PIXELS );
+
+    for ( int i = 0; i < PASSES; ++i ) {
+        if ( parallel ) {
+            QtConcurrent::blockingMap( rows, RowBlur( horizontal ) );
+            QtConcurrent::blockingMap( columns, ColumnBlur( vertical ) );
+        } else {
+            blurRows( horizontal, rows.first() );
+            blurColumns( vertical, columns.first() );
+        }
+    }
+}
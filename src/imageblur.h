@@ -0,0 +1,47 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_IMAGEBLUR_H
+#define RSIBREAK_IMAGEBLUR_H
+
+#include "imagescaler.h"
+
+#include <QImage>
+
+/**
+ * @class ImageBlur
+ * Fast approximation of a Gaussian blur by three box blur passes, each
+ * split in a horizontal and a vertical pass. Every pass is run on the
+ * global thread pool, rows or column strips in parallel. The vertical
+ * pass has scalar, SSE2 and AVX2 kernels, the horizontal one scalar and
+ * SSE2 kernels, chosen like ImageScaler does.
+ *
+ * For strong blurs it is much cheaper to blur a downscaled copy, the
+ * result looks the same once scaled back up.
+ */
+class ImageBlur
+{
+public:
+    /**
+     * Blurs @p image in place. Images that are not Format_RGB32 or
+     * Format_ARGB32_Premultiplied are converted first.
+     * @param radius Radius of each box pass, the Gaussian it approximates
+     * has a standard deviation of about radius.
+     */
+    static void blur( QImage* image, int radius, ImageScaler::Kernel kernel = ImageScaler::Auto );
+};
+
+#endif // RSIBREAK_IMAGEBLUR_H
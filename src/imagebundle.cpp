@@ -0,0 +1,229 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "imagebundle.h"
+
+#include <QDebug>
+#include <QtEndian>
+
+#include <limits>
+#include <string.h>
+
+const char ImageBundle::Magic[8] = { 'R', 'S', 'I', 'B', 'N', 'D', 'L', '\0' };
+
+ImageBundle::ImageBundle()
+    : m_data( nullptr )
+    , m_size( 0 )
+    , m_count( 0 )
+    , m_index( nullptr )
+{
+}
+
+ImageBundle::~ImageBundle()
+{
+    close();
+}
+
+bool ImageBundle::isBundle( const QString& path )
+{
+    return path.endsWith( QLatin1Char( '.' ) + QLatin1String( Suffix ), Qt::CaseInsensitive );
+}
+
+bool ImageBundle::open( const QString& path )
+{
+    close();
+
+    m_file.setFileName( path );
+    if ( !m_file.open( QIODevice::ReadOnly ) ) {
+        qWarning() << "Could not open image bundle" << path << m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if ( size < HeaderSize ) {
+        qWarning() << "Image bundle is truncated:" << path;
+        m_file.close();
+        return false;
+    }
+
+    const uchar* data = m_file.map( 0, size );
+    // The mapping stays valid after closing the file descriptor.
+    m_file.close();
+    if ( !data ) {
+        qWarning() << "Could not map image bundle" << path;
+        return false;
+    }
+
+    const quint32 version = qFromLittleEndian<quint32>( data + 8 );
+    const quint32 count = qFromLittleEndian<quint32>( data + 12 );
+    const quint64 indexOffset = qFromLittleEndian<quint64>( data + 16 );
+
+    if ( memcmp( data, Magic, sizeof( Magic ) ) != 0 || version != Version ||
+            count > quint32( std::numeric_limits<int>::max() ) ||
+            indexOffset < quint64( HeaderSize ) || indexOffset > quint64( size ) ||
+            ( quint64( size ) - indexOffset ) / EntrySize < count ) {
+        qWarning() << "Not a valid image bundle:" << path;
+        m_file.unmap( const_cast<uchar*>( data ) );
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_count = count;
+    m_index = data + indexOffset;
+    return true;
+}
+
+void ImageBundle::close()
+{
+    if ( m_data )
+        m_file.unmap( const_cast<uchar*>( m_data ) );
+
+    m_data = nullptr;
+    m_size = 0;
+    m_count = 0;
+    m_index = nullptr;
+}
+
+const uchar* ImageBundle::entry( int index ) const
+{
+    if ( index < 0 || index >= m_count )
+        return nullptr;
+
+    return m_index + index * EntrySize;
+}
+
+QSize ImageBundle::imageSize( int index ) const
+{
+    const uchar* e = entry( index );
+    if ( !e )
+        return QSize();
+
+    return QSize( qFromLittleEndian<quint16>( e + 12 ), qFromLittleEndian<quint16>( e + 14 ) );
+}
+
+QByteArray ImageBundle::rawData( int index ) const
+{
+    const uchar* e = entry( index );
+    if ( !e )
+        return QByteArray();
+
+    const quint64 offset = qFromLittleEndian<quint64>( e );
+    const quint32 size = qFromLittleEndian<quint32>( e + 8 );
+    if ( offset < quint64( HeaderSize ) || offset > quint64( m_size ) ||
+            size > quint64( m_size ) - offset ) {
+        qWarning() << "Image bundle entry" << index << "points outside of the file";
+        return QByteArray();
+    }
+
+    return QByteArray::fromRawData( reinterpret_cast<const char*>( m_data + offset ), size );
+}
+
+QImage ImageBundle::image( int index ) const
+{
+    const QByteArray data = rawData( index );
+    if ( data.isEmpty() )
+        return QImage();
+
+    return QImage::fromData( data );
+}
+
+// ------------------------ ImageBundleWriter -------------//
+
+ImageBundleWriter::ImageBundleWriter()
+{
+}
+
+ImageBundleWriter::~ImageBundleWriter()
+{
+    if ( m_file.isOpen() )
+        m_file.close();
+}
+
+bool ImageBundleWriter::open( const QString& path )
+{
+    m_entries.clear();
+    m_file.setFileName( path );
+    if ( !m_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+        qWarning() << "Could not create image bundle" << path << m_file.errorString();
+        return false;
+    }
+
+    // Placeholder, the real header is written once the index position is known.
+    return writeHeader( 0, 0 );
+}
+
+bool ImageBundleWriter::add( const QByteArray& data, const QSize& size )
+{
+    if ( !m_file.isOpen() || data.isEmpty() )
+        return false;
+
+    if ( size.width() > 0xffff || size.height() > 0xffff ) {
+        qWarning() << "Image too large for a bundle:" << size;
+        return false;
+    }
+
+    Entry e;
+    e.offset = m_file.pos();
+    e.size = data.size();
+    e.width = size.width();
+    e.height = size.height();
+
+    if ( m_file.write( data ) != data.size() )
+        return false;
+
+    m_entries.append( e );
+    return true;
+}
+
+bool ImageBundleWriter::finish()
+{
+    if ( !m_file.isOpen() )
+        return false;
+
+    const quint64 indexOffset = m_file.pos();
+
+    QByteArray index( m_entries.count() * ImageBundle::EntrySize, Qt::Uninitialized );
+    uchar* p = reinterpret_cast<uchar*>( index.data() );
+    foreach( const Entry& e, m_entries ) {
+        qToLittleEndian<quint64>( e.offset, p );
+        qToLittleEndian<quint32>( e.size, p + 8 );
+        qToLittleEndian<quint16>( e.width, p + 12 );
+        qToLittleEndian<quint16>( e.height, p + 14 );
+        p += ImageBundle::EntrySize;
+    }
+
+    bool ok = m_file.write( index ) == index.size();
+    ok = ok && m_file.seek( 0 ) && writeHeader( m_entries.count(), indexOffset );
+    m_file.close();
+    return ok;
+}
+
+int ImageBundleWriter::count() const
+{
+    return m_entries.count();
+}
+
+bool ImageBundleWriter::writeHeader( quint32 count, quint64 indexOffset )
+{
+    uchar header[ImageBundle::HeaderSize];
+    memcpy( header, ImageBundle::Magic, sizeof( ImageBundle::Magic ) );
+    qToLittleEndian<quint32>( ImageBundle::Version, header + 8 );
+    qToLittleEndian<quint32>( count, header + 12 );
+    qToLittleEndian<quint64>( indexOffset, header + 16 );
+
+    return m_file.write( reinterpret_cast<const char*>( header ), sizeof( header ) ) == sizeof( header );
+}
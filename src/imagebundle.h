@@ -0,0 +1,147 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef RSIBREAK_IMAGEBUNDLE_H
+#define RSIBREAK_IMAGEBUNDLE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class ImageBundle
+ * Read-only access to a packed image bundle as written by the
+ * rsibreak-bundle tool. The whole file is memory mapped once, so showing
+ * an image does not need any file system access at all, which matters
+ * when the images live on a network file system.
+ *
+ * Layout, all integers little endian:
+ *   header:  8 byte magic "RSIBNDL\0", quint32 version, quint32 count,
+ *            quint64 offset of the index
+ *   data:    the encoded images, back to back
+ *   index:   count entries of quint64 offset, quint32 size,
+ *            quint16 width, quint16 height
+ */
+class ImageBundle
+{
+public:
+    static const char Magic[8];
+    static constexpr quint32 Version = 1;
+    static constexpr int HeaderSize = 24;
+    static constexpr int EntrySize = 16;
+    static constexpr const char* Suffix = "rsibundle";
+
+    ImageBundle();
+    ~ImageBundle();
+
+    /**
+     * Maps the bundle at @p path. Any previously opened bundle is closed.
+     * @returns false if the file can not be mapped or is not a valid bundle.
+     */
+    bool open( const QString& path );
+
+    /** Unmaps the bundle. */
+    void close();
+
+    bool isOpen() const {
+        return m_data != nullptr;
+    }
+
+    /** @returns the number of images in the bundle. */
+    int count() const {
+        return m_count;
+    }
+
+    /** @returns the stored size of image @p index, without decoding it. */
+    QSize imageSize( int index ) const;
+
+    /**
+     * @returns the encoded bytes of image @p index. The array does not own
+     * its data, it points into the mapping and is valid while the bundle
+     * stays open.
+     */
+    QByteArray rawData( int index ) const;
+
+    /**
+     * Decodes image @p index straight from the mapping.
+     * @returns a null image for an invalid index or undecodable data.
+     */
+    QImage image( int index ) const;
+
+    /**
+     * Quick check whether @p path looks like a bundle, based on its name.
+     */
+    static bool isBundle( const QString& path );
+
+private:
+    const uchar* entry( int index ) const;
+
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    int m_count;
+    const uchar* m_index;
+
+    Q_DISABLE_COPY( ImageBundle )
+};
+
+/**
+ * @class ImageBundleWriter
+ * Writes the format read by ImageBundle. Images are appended one by one,
+ * already encoded, and the index is written by finish().
+ */
+class ImageBundleWriter
+{
+public:
+    ImageBundleWriter();
+    ~ImageBundleWriter();
+
+    /** Creates or truncates the bundle at @p path. */
+    bool open( const QString& path );
+
+    /**
+     * Appends an encoded image.
+     * @param data The encoded image, in any format QImageReader can read.
+     * @param size The size of the image, stored in the index.
+     */
+    bool add( const QByteArray& data, const QSize& size );
+
+    /** Writes the index and the final header, then closes the file. */
+    bool finish();
+
+    /** @returns the number of images added so far. */
+    int count() const;
+
+private:
+    struct Entry {
+        quint64 offset;
+        quint32 size;
+        quint16 width;
+        quint16 height;
+    };
+
+    bool writeHeader( quint32 count, quint64 indexOffset );
+
+    QFile m_file;
+    QVector<Entry> m_entries;
+
+    Q_DISABLE_COPY( ImageBundleWriter )
+};
+
+#endif // RSIBREAK_IMAGEBUNDLE_H
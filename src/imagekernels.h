@@ -0,0 +1,42 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_IMAGEKERNELS_H
+#define RSIBREAK_IMAGEKERNELS_H
+
+/*
+  Shared by the image kernels of ImageScaler and ImageBlur: which SIMD
+  kernels can be compiled in, ImageScaler::isSupported() tells which of
+  them can run.
+*/
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#include <immintrin.h>
+#define RSIBREAK_HAVE_AVX2 1
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RSIBREAK_HAVE_SSE2 1
+#endif
+
+namespace ImageKernels
+{
+// Below this many pixels threading costs more than it saves.
+const int PARALLEL_THRESHOLD = 256 * 256;
+}
+
+#endif // RSIBREAK_IMAGEKERNELS_H
@@ -0,0 +1,350 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include "imagescaler.h"
+#include "imagekernels.h"
+
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+
+/*
+  For every target pixel along one axis, the range of source pixels it
+  covers and the normalized share of each of them.
+*/
+struct Contributions {
+    QVector<int> first;
+    QVector<int> count;
+    QVector<int> offset;
+    QVector<float> weights;
+};
+
+/*
+  Target pixels [from, to) of an axis of @p dstSize pixels, mapped onto
+  @p srcSize source pixels.
+*/
+void computeContributions( int srcSize, int dstSize, int from, int to, Contributions* c )
+{
+    const double scale = double( srcSize ) / dstSize;
+    const int n = to - from;
+    c->first.resize( n );
+    c->count.resize( n );
+    c->offset.resize( n );
+    c->weights.clear();
+    c->weights.reserve( n * ( int( scale ) + 2 ) );
+
+    for ( int i = 0; i < n; ++i ) {
+        const double left = ( from + i ) * scale;
+        const double right = qMin( ( from + i + 1 ) * scale, double( srcSize ) );
+        const int first = qBound( 0, int( std::floor( left ) ), srcSize - 1 );
+        const int last = qBound( first, int( std::ceil( right ) ) - 1, srcSize - 1 );
+
+        c->first[i] = first;
+        c->count[i] = last - first + 1;
+        c->offset[i] = c->weights.count();
+
+        double sum = 0;
+        for ( int s = first; s <= last; ++s ) {
+            const double w = qMax( 0.0, qMin( right, s + 1.0 ) - qMax( left, double( s ) ) );
+            c->weights.append( w );
+            sum += w;
+        }
+        for ( int k = c->offset[i]; k < c->weights.count(); ++k )
+            c->weights[k] = sum > 0 ? c->weights[k] / sum : 1.0f / c->count[i];
+    }
+}
+
+// acc[0 .. 4 * pixels) += weight * row[0 .. pixels), per channel.
+typedef void ( *VerticalKernel )( float* acc, const quint32* row, int pixels, float weight );
+
+// out[x] = sum of weights * acc for each target pixel x of the band.
+typedef void ( *HorizontalKernel )( const float* acc, quint32* out, const Contributions& c, int colStart );
+
+void verticalScalar( float* acc, const quint32* row, int pixels, float weight )
+{
+    const uchar* p = reinterpret_cast<const uchar*>( row );
+    for ( int i = 0; i < pixels * 4; ++i )
+        acc[i] += weight * p[i];
+}
+
+void horizontalScalar( const float* acc, quint32* out, const Contributions& c, int colStart )
+{
+    for ( int x = 0; x < c.first.count(); ++x ) {
+        float sum[4] = { 0, 0, 0, 0 };
+        const float* w = c.weights.constData() + c.offset[x];
+        const float* a = acc + ( c.first[x] - colStart ) * 4;
+        for ( int k = 0; k < c.count[x]; ++k, a += 4 ) {
+            sum[0] += w[k] * a[0];
+            sum[1] += w[k] * a[1];
+            sum[2] += w[k] * a[2];
+            sum[3] += w[k] * a[3];
+        }
+
+        uchar* o = reinterpret_cast<uchar*>( out + x );
+        for ( int ch = 0; ch < 4; ++ch )
+            o[ch] = uchar( qBound( 0, int( sum[ch] + 0.5f ), 255 ) );
+    }
+}
+
+#ifdef RSIBREAK_HAVE_SSE2
+void verticalSSE2( float* acc, const quint32* row, int pixels, float weight )
+{
+    const __m128 w = _mm_set1_ps( weight );
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for ( ; i + 4 <= pixels; i += 4 ) {
+        const __m128i px = _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + i ) );
+        const __m128i lo = _mm_unpacklo_epi8( px, zero );
+        const __m128i hi = _mm_unpackhi_epi8( px, zero );
+        float* a = acc + i * 4;
+
+        const __m128 c0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) );
+        const __m128 c1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) );
+        const __m128 c2 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) );
+        const __m128 c3 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) );
+
+        _mm_storeu_ps( a, _mm_add_ps( _mm_loadu_ps( a ), _mm_mul_ps( w, c0 ) ) );
+        _mm_storeu_ps( a + 4, _mm_add_ps( _mm_loadu_ps( a + 4 ), _mm_mul_ps( w, c1 ) ) );
+        _mm_storeu_ps( a + 8, _mm_add_ps( _mm_loadu_ps( a + 8 ), _mm_mul_ps( w, c2 ) ) );
+        _mm_storeu_ps( a + 12, _mm_add_ps( _mm_loadu_ps( a + 12 ), _mm_mul_ps( w, c3 ) ) );
+    }
+
+    verticalScalar( acc + i * 4, row + i, pixels - i, weight );
+}
+
+void horizontalSSE2( const float* acc, quint32* out, const Contributions& c, int colStart )
+{
+    for ( int x = 0; x < c.first.count(); ++x ) {
+        __m128 sum = _mm_setzero_ps();
+        const float* w = c.weights.constData() + c.offset[x];
+        const float* a = acc + ( c.first[x] - colStart ) * 4;
+        for ( int k = 0; k < c.count[x]; ++k, a += 4 )
+            sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( w[k] ), _mm_loadu_ps( a ) ) );
+
+        // Round, then saturate to 0..255 on the way down to bytes.
+        __m128i v = _mm_cvtps_epi32( sum );
+        v = _mm_packs_epi32( v, v );
+        v = _mm_packus_epi16( v, v );
+        out[x] = _mm_cvtsi128_si32( v );
+    }
+}
+#endif
+
+#ifdef RSIBREAK_HAVE_AVX2
+__attribute__(( target( "avx2" ) ))
+void verticalAVX2( float* acc, const quint32* row, int pixels, float weight )
+{
+    const __m256 w = _mm256_set1_ps( weight );
+
+    int i = 0;
+    for ( ; i + 8 <= pixels; i += 8 ) {
+        const __m128i p0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + i ) );
+        const __m128i p1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + i + 4 ) );
+        float* a = acc + i * 4;
+
+        // Two pixels, eight channels, per register.
+        const __m256 c0 = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( p0 ) );
+        const __m256 c1 = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_srli_si128( p0, 8 ) ) );
+        const __m256 c2 = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( p1 ) );
+        const __m256 c3 = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_srli_si128( p1, 8 ) ) );
+
+        _mm256_storeu_ps( a, _mm256_add_ps( _mm256_loadu_ps( a ), _mm256_mul_ps( w, c0 ) ) );
+        _mm256_storeu_ps( a + 8, _mm256_add_ps( _mm256_loadu_ps( a + 8 ), _mm256_mul_ps( w, c1 ) ) );
+        _mm256_storeu_ps( a + 16, _mm256_add_ps( _mm256_loadu_ps( a + 16 ), _mm256_mul_ps( w, c2 ) ) );
+        _mm256_storeu_ps( a + 24, _mm256_add_ps( _mm256_loadu_ps( a + 24 ), _mm256_mul_ps( w, c3 ) ) );
+    }
+
+    verticalScalar( acc + i * 4, row + i, pixels - i, weight );
+}
+#endif
+
+struct ScaleJob {
+    const uchar* src;
+    int srcBytesPerLine;
+    uchar* dst;
+    int dstBytesPerLine;
+
+    // Visible target columns and rows, in dst coordinates.
+    int left;
+    int top;
+
+    // Source columns needed for the visible target columns.
+    int colStart;
+    int colEnd;
+
+    Contributions x;
+    Contributions y;
+
+    VerticalKernel vertical;
+    HorizontalKernel horizontal;
+};
+
+struct Band {
+    int first;
+    int last;
+};
+
+void scaleBand( const ScaleJob& job, const Band& band )
+{
+    // One accumulator row per thread, kept between calls.
+    thread_local std::vector<float> acc;
+    const int cols = job.colEnd - job.colStart;
+    if ( int( acc.size() ) < cols * 4 )
+        acc.resize( cols * 4 );
+
+    for ( int i = band.first; i < band.last; ++i ) {
+        memset( acc.data(), 0, cols * 4 * sizeof( float ) );
+
+        const float* w = job.y.weights.constData() + job.y.offset[i];
+        for ( int k = 0; k < job.y.count[i]; ++k ) {
+            const uchar* line = job.src + qptrdiff( job.y.first[i] + k ) * job.srcBytesPerLine;
+            job.vertical( acc.data(), reinterpret_cast<const quint32*>( line ) + job.colStart, cols, w[k] );
+        }
+
+        uchar* line = job.dst + qptrdiff( job.top + i ) * job.dstBytesPerLine;
+        job.horizontal( acc.data(), reinterpret_cast<quint32*>( line ) + job.left, job.x, job.colStart );
+    }
+}
+
+// Functor for QtConcurrent::blockingMap.
+struct BandScaler {
+    typedef void result_type;
+
+    explicit BandScaler( const ScaleJob& job ) : m_job( job ) {}
+
+    void operator()( const Band& band ) const {
+        scaleBand( m_job, band );
+    }
+
+    const ScaleJob& m_job;
+};
+
+}
+
+ImageScaler::Kernel ImageScaler::bestKernel()
+{
+    if ( isSupported( AVX2 ) )
+        return AVX2;
+    if ( isSupported( SSE2 ) )
+        return SSE2;
+    return Scalar;
+}
+
+bool ImageScaler::isSupported( Kernel kernel )
+{
+    switch ( kernel ) {
+    case Auto:
+    case Scalar:
+        return true;
+    case SSE2:
+#ifdef RSIBREAK_HAVE_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+#if defined(RSIBREAK_HAVE_AVX2) && defined(RSIBREAK_HAVE_SSE2)
+        return __builtin_cpu_supports( "avx2" );
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+void ImageScaler::scale( const QImage& source, QImage* dst, const QRect& target, Kernel kernel )
+{
+    if ( source.isNull() || !dst || dst->isNull() || target.isEmpty() )
+        return;
+
+    Q_ASSERT( dst->depth() == 32 );
+
+    // Averaging needs premultiplied alpha, most photos are RGB32 already.
+    const QImage src = ( source.format() == QImage::Format_RGB32 ||
+                         source.format() == QImage::Format_ARGB32_Premultiplied )
+                       ? source : source.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+    const QRect visible = target & dst->rect();
+    if ( visible.isEmpty() )
+        return;
+
+    if ( kernel == Auto || !isSupported( kernel ) )
+        kernel = bestKernel();
+
+    ScaleJob job;
+    job.src = src.constBits();
+    job.srcBytesPerLine = src.bytesPerLine();
+    job.dst = dst->bits();
+    job.dstBytesPerLine = dst->bytesPerLine();
+    job.left = visible.left();
+    job.top = visible.top();
+    job.vertical = verticalScalar;
+    job.horizontal = horizontalScalar;
+#ifdef RSIBREAK_HAVE_SSE2
+    if ( kernel == SSE2 || kernel == AVX2 ) {
+        job.vertical = verticalSSE2;
+        job.horizontal = horizontalSSE2;
+    }
+#endif
+#if defined(RSIBREAK_HAVE_AVX2) && defined(RSIBREAK_HAVE_SSE2)
+    if ( kernel == AVX2 )
+        job.vertical = verticalAVX2;
+#endif
+
+    computeContributions( src.width(), target.width(),
+                          visible.left() - target.left(), visible.right() + 1 - target.left(), &job.x );
+    computeContributions( src.height(), target.height(),
+                          visible.top() - target.top(), visible.bottom() + 1 - target.top(), &job.y );
+
+    const int lastX = job.x.first.count() - 1;
+    job.colStart = job.x.first[0];
+    job.colEnd = job.x.first[lastX] + job.x.count[lastX];
+
+    const int rows = visible.height();
+    if ( visible.width() * rows < ImageKernels::PARALLEL_THRESHOLD ) {
+        Band all = { 0, rows };
+        scaleBand( job, all );
+        return;
+    }
+
+    const int bandCount = qMin( rows, QThread::idealThreadCount() * 4 );
+    QVector<Band> bands( bandCount );
+    for ( int b = 0; b < bandCount; ++b ) {
+        bands[b].first = rows * b / bandCount;
+        bands[b].last = rows * ( b + 1 ) / bandCount;
+    }
+
+    QtConcurrent::blockingMap( bands, BandScaler( job ) );
+}
+
+QImage ImageScaler::scaled( const QImage& src, const QSize& size, Kernel kernel )
+{
+    if ( src.isNull() || size.isEmpty() )
+        return QImage();
+
+    QImage dst( size, src.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                            : QImage::Format_RGB32 );
+    scale( src, &dst, dst.rect(), kernel );
+    return dst;
+}
@@ -0,0 +1,68 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef RSIBREAK_IMAGESCALER_H
+#define RSIBREAK_IMAGESCALER_H
+
+#include <QImage>
+#include <QRect>
+
+/**
+ * @class ImageScaler
+ * High quality area averaging scaler for the break screens. Every target
+ * pixel is the weighted average of the source area it covers, which avoids
+ * the aliasing of Qt::FastTransformation when shrinking photos, at a
+ * fraction of the cost of Qt::SmoothTransformation.
+ *
+ * The work is split in bands of target rows which are scaled in parallel
+ * on the global thread pool. Each band first averages the source rows
+ * vertically into a float row and then averages that row horizontally.
+ * The vertical step has scalar, SSE2 and AVX2 kernels, the horizontal one
+ * scalar and SSE2 kernels; the best one is picked at runtime.
+ *
+ * Only 32 bit formats without alpha or with premultiplied alpha are
+ * handled directly, other formats are converted first.
+ */
+class ImageScaler
+{
+public:
+    enum Kernel {
+        Auto = 0,
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * Scales @p src into the rectangle @p target of @p dst. The target may
+     * be larger than @p dst, only the visible part is computed, so an image
+     * expanded to cover the screen is cropped for free.
+     * @p dst must be Format_RGB32, Format_ARGB32_Premultiplied or
+     * Format_ARGB32 with a @p src without alpha.
+     */
+    static void scale( const QImage& src, QImage* dst, const QRect& target, Kernel kernel = Auto );
+
+    /** Convenience version returning a new image of @p size. */
+    static QImage scaled( const QImage& src, const QSize& size, Kernel kernel = Auto );
+
+    /** @returns the fastest kernel supported by this CPU. */
+    static Kernel bestKernel();
+
+    /** @returns whether @p kernel can run on this CPU. */
+    static bool isSupported( Kernel kernel );
+};
+
+#endif // RSIBREAK_IMAGESCALER_H
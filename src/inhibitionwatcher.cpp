@@ -0,0 +1,171 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "inhibitionwatcher.h"
+
+#include <QCoreApplication>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QDBusVariant>
+#include <QDebug>
+
+#include <KWindowInfo>
+#include <KWindowSystem>
+
+namespace
+{
+
+const char POWER_MANAGEMENT_PATH[] = "/org/freedesktop/PowerManagement/Inhibit";
+const char POWER_MANAGEMENT_INTERFACE[] = "org.freedesktop.PowerManagement.Inhibit";
+const char NOTIFICATIONS_PATH[] = "/org/freedesktop/Notifications";
+const char NOTIFICATIONS_INTERFACE[] = "org.freedesktop.Notifications";
+const char PROPERTIES_INTERFACE[] = "org.freedesktop.DBus.Properties";
+
+}
+
+InhibitionWatcher::InhibitionWatcher( const QDBusConnection& connection,
+                                      const QString& powerManagementService,
+                                      const QString& notificationsService, QObject* parent )
+    : QObject( parent )
+    , m_connection( connection )
+    , m_powerManagementService( powerManagementService.isEmpty() ?
+                                QStringLiteral( "org.freedesktop.PowerManagement" ) : powerManagementService )
+    , m_notificationsService( notificationsService.isEmpty() ?
+                              QStringLiteral( "org.freedesktop.Notifications" ) : notificationsService )
+    , m_reasons( NoReason )
+{
+    m_connection.connect( m_powerManagementService, POWER_MANAGEMENT_PATH, POWER_MANAGEMENT_INTERFACE,
+                          QStringLiteral( "HasInhibitChanged" ), this, SLOT( slotHasInhibitChanged( bool ) ) );
+    m_connection.connect( m_notificationsService, NOTIFICATIONS_PATH, PROPERTIES_INTERFACE,
+                          QStringLiteral( "PropertiesChanged" ), this,
+                          SLOT( slotNotificationsChanged( QString, QVariantMap, QStringList ) ) );
+
+    // A restarted service starts without inhibitions of the old one.
+    QDBusServiceWatcher* services = new QDBusServiceWatcher( this );
+    services->setConnection( m_connection );
+    services->addWatchedService( m_powerManagementService );
+    services->addWatchedService( m_notificationsService );
+    connect( services, &QDBusServiceWatcher::serviceRegistered, this, &InhibitionWatcher::slotServiceRegistered );
+    connect( services, &QDBusServiceWatcher::serviceUnregistered, this, &InhibitionWatcher::slotServiceUnregistered );
+
+    queryPowerManagement();
+    queryNotifications();
+}
+
+void InhibitionWatcher::watchFullScreen()
+{
+    connect( KWindowSystem::self(), &KWindowSystem::activeWindowChanged,
+             this, &InhibitionWatcher::slotActiveWindowChanged );
+    connect( KWindowSystem::self(), static_cast<void ( KWindowSystem::* )( WId, NET::Properties, NET::Properties2 )>(
+                 &KWindowSystem::windowChanged ), this, &InhibitionWatcher::slotWindowChanged );
+    slotActiveWindowChanged();
+}
+
+void InhibitionWatcher::queryPowerManagement()
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall( m_powerManagementService, POWER_MANAGEMENT_PATH,
+                                                       POWER_MANAGEMENT_INTERFACE, QStringLiteral( "HasInhibit" ) );
+    QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher( m_connection.asyncCall( msg ), this );
+    connect( watcher, &QDBusPendingCallWatcher::finished, this, [this]( QDBusPendingCallWatcher * w ) {
+        QDBusPendingReply<bool> reply = *w;
+        // Without the service nothing is inhibited.
+        setReason( ScreenSaverInhibited, !reply.isError() && reply.value() );
+        w->deleteLater();
+    } );
+}
+
+void InhibitionWatcher::queryNotifications()
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall( m_notificationsService, NOTIFICATIONS_PATH,
+                                                       PROPERTIES_INTERFACE, QStringLiteral( "Get" ) );
+    msg << QString( NOTIFICATIONS_INTERFACE ) << QStringLiteral( "Inhibited" );
+    QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher( m_connection.asyncCall( msg ), this );
+    connect( watcher, &QDBusPendingCallWatcher::finished, this, [this]( QDBusPendingCallWatcher * w ) {
+        QDBusPendingReply<QDBusVariant> reply = *w;
+        // Notification servers other than Plasma's have no such property.
+        setReason( NotificationsInhibited, !reply.isError() && reply.value().variant().toBool() );
+        w->deleteLater();
+    } );
+}
+
+void InhibitionWatcher::slotServiceRegistered( const QString& service )
+{
+    if ( service == m_powerManagementService )
+        queryPowerManagement();
+    if ( service == m_notificationsService )
+        queryNotifications();
+}
+
+void InhibitionWatcher::slotServiceUnregistered( const QString& service )
+{
+    if ( service == m_powerManagementService )
+        setReason( ScreenSaverInhibited, false );
+    if ( service == m_notificationsService )
+        setReason( NotificationsInhibited, false );
+}
+
+void InhibitionWatcher::slotHasInhibitChanged( bool hasInhibit )
+{
+    setReason( ScreenSaverInhibited, hasInhibit );
+}
+
+void InhibitionWatcher::slotNotificationsChanged( const QString& interface, const QVariantMap& changed,
+                                                  const QStringList& invalidated )
+{
+    if ( interface != QLatin1String( NOTIFICATIONS_INTERFACE ) )
+        return;
+
+    if ( changed.contains( QStringLiteral( "Inhibited" ) ) )
+        setReason( NotificationsInhibited, changed.value( QStringLiteral( "Inhibited" ) ).toBool() );
+    else if ( invalidated.contains( QStringLiteral( "Inhibited" ) ) )
+        queryNotifications();
+}
+
+void InhibitionWatcher::slotActiveWindowChanged()
+{
+    const WId active = KWindowSystem::activeWindow();
+    if ( !active ) {
+        setReason( FullScreenWindow, false );
+        return;
+    }
+
+    // The break screens of RSIBreak are full screen themselves.
+    KWindowInfo info( active, NET::WMState | NET::WMPid );
+    setReason( FullScreenWindow, info.valid() && info.hasState( NET::FullScreen ) &&
+               info.pid() != QCoreApplication::applicationPid() );
+}
+
+void InhibitionWatcher::slotWindowChanged( WId id, NET::Properties properties, NET::Properties2 )
+{
+    if ( id == KWindowSystem::activeWindow() && ( properties & NET::WMState ) )
+        slotActiveWindowChanged();
+}
+
+void InhibitionWatcher::setReason( Reason reason, bool set )
+{
+    const bool wasInhibited = isInhibited();
+    if ( set )
+        m_reasons |= reason;
+    else
+        m_reasons &= ~Reasons( reason );
+
+    if ( isInhibited() != wasInhibited ) {
+        qDebug() << "Breaks are" << ( isInhibited() ? "deferred" : "allowed again" ) << m_reasons;
+        emit inhibitedChanged( isInhibited() );
+    }
+}
@@ -0,0 +1,98 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_INHIBITIONWATCHER_H
+#define RSIBREAK_INHIBITIONWATCHER_H
+
+#include <QDBusConnection>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#include <netwm_def.h>
+
+class QDBusPendingCallWatcher;
+
+/**
+ * @class InhibitionWatcher
+ * Knows whether the user asked not to be disturbed: an application holds
+ * a screen saver inhibition, notifications are turned off or the active
+ * window is full screen, as during a presentation or a video call.
+ *
+ * The state is asked for once when a service appears and then only
+ * follows its change signals, nothing is polled. Users of the flag cache
+ * it from inhibitedChanged().
+ */
+class InhibitionWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Reason {
+        NoReason = 0,
+        ScreenSaverInhibited = 1 << 0,     ///< org.freedesktop.PowerManagement.Inhibit
+        NotificationsInhibited = 1 << 1,   ///< Inhibited of org.freedesktop.Notifications
+        FullScreenWindow = 1 << 2          ///< the active window of another application
+    };
+    Q_DECLARE_FLAGS( Reasons, Reason )
+
+    /**
+     * Watches the services on @p connection. Empty service names use the
+     * well known names, tests pass the names of mock services instead.
+     */
+    explicit InhibitionWatcher( const QDBusConnection& connection,
+                                const QString& powerManagementService = QString(),
+                                const QString& notificationsService = QString(),
+                                QObject* parent = 0 );
+
+    /** Follows the full screen state of the active window as well. */
+    void watchFullScreen();
+
+    Reasons reasons() const {
+        return m_reasons;
+    }
+
+    bool isInhibited() const {
+        return m_reasons != NoReason;
+    }
+
+signals:
+    /** The user started or stopped asking not to be disturbed. */
+    void inhibitedChanged( bool inhibited );
+
+private slots:
+    void slotServiceRegistered( const QString& service );
+    void slotServiceUnregistered( const QString& service );
+    void slotHasInhibitChanged( bool hasInhibit );
+    void slotNotificationsChanged( const QString& interface, const QVariantMap& changed,
+                                   const QStringList& invalidated );
+    void slotActiveWindowChanged();
+    void slotWindowChanged( WId id, NET::Properties properties, NET::Properties2 properties2 );
+
+private:
+    void queryPowerManagement();
+    void queryNotifications();
+    void setReason( Reason reason, bool set );
+
+    QDBusConnection m_connection;
+    QString m_powerManagementService;
+    QString m_notificationsService;
+    Reasons m_reasons;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS( InhibitionWatcher::Reasons )
+
+#endif // RSIBREAK_INHIBITIONWATCHER_H
@@ -17,11 +17,9 @@
 */
 
 #include "plasmaeffect.h"
+#include "dbusclient.h"
 
 #include <QApplication>
-#include <QDebug>
-#include <QDesktopWidget>
-#include <QDBusInterface>
 
 PlasmaEffect::PlasmaEffect( QObject* parent )
         : BreakBase( parent )
@@ -29,35 +27,25 @@ PlasmaEffect::PlasmaEffect( QObject* parent )
     // Make all other screens gray...
     slotGray();
 
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &PlasmaEffect::slotGray );
+    connect( qApp, &QGuiApplication::primaryScreenChanged, this, &PlasmaEffect::slotGray );
 }
 
 void PlasmaEffect::slotGray()
 {
     // Make all other screens gray...
     setGrayEffectOnAllScreens( true );
-    excludeGrayEffectOnScreen( QApplication::desktop()->primaryScreen() );
+    excludeGrayEffectOnScreen( QGuiApplication::primaryScreen() );
 }
 
 void PlasmaEffect::activate()
 {
-    QDBusInterface dbus( "org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell" );
-    QDBusMessage reply = dbus.call( QLatin1String( "setDashboardShown" ), true );
+    // Asynchronous, a slow Plasma shell must not delay the break screen.
+    DBusClient::instance()->setDashboardShown( true );
     BreakBase::activate();
-
-    if ( reply.type() == QDBusMessage::ErrorMessage ) {
-        qWarning() << reply.errorMessage() << reply.errorName();
-    }
 }
 
 void PlasmaEffect::deactivate()
 {
-    QDBusInterface dbus( "org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell" );
-    QDBusMessage reply = dbus.call( QLatin1String( "setDashboardShown" ), false );
-
-    if ( reply.type() == QDBusMessage::ErrorMessage ) {
-        qWarning() << reply.errorMessage() << reply.errorName();
-    }
-
+    DBusClient::instance()->setDashboardShown( false );
     BreakBase::deactivate();
 }
@@ -0,0 +1,97 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "progressicon.h"
+
+#include <QGuiApplication>
+#include <QPainter>
+
+// The sizes the icon is installed in, which tray hosts pick from.
+static const int SIZES[] = { 16, 22, 32, 48 };
+
+ProgressIcon::ProgressIcon()
+    : m_frames( FRAME_COUNT )
+{
+    const qreal ratio = qApp ? qApp->devicePixelRatio() : 1.0;
+    const QIcon face = QIcon::fromTheme( "rsibreak0" );
+    for ( int size : SIZES ) {
+        const int pixels = qRound( size * ratio );
+        QPixmap pixmap = face.pixmap( pixels, pixels );
+        if ( pixmap.size() != QSize( pixels, pixels ) ) {
+            // Not installed, as in tests: draw a plain face instead.
+            pixmap = QPixmap( pixels, pixels );
+            pixmap.fill( Qt::transparent );
+            QPainter p( &pixmap );
+            p.setRenderHint( QPainter::Antialiasing );
+            p.setPen( QPen( Qt::darkGray, pixels / 12.0 ) );
+            p.setBrush( QColor( 90, 60, 170 ) );
+            p.drawEllipse( QRectF( pixmap.rect() ).adjusted( 1, 1, -1, -1 ) );
+        }
+        pixmap.setDevicePixelRatio( ratio );
+        m_faces.append( pixmap );
+    }
+}
+
+int ProgressIcon::frameFor( double progress )
+{
+    return qBound( 0, qRound( progress * ( FRAME_COUNT - 1 ) / 100.0 ), FRAME_COUNT - 1 );
+}
+
+const QIcon& ProgressIcon::frame( int index )
+{
+    index = qBound( 0, index, FRAME_COUNT - 1 );
+    if ( m_frames[index].isNull() )
+        m_frames[index] = render( index );
+    return m_frames[index];
+}
+
+const QIcon& ProgressIcon::suspended()
+{
+    if ( m_suspended.isNull() ) {
+        const QIcon theme = QIcon::fromTheme( "rsibreakx" );
+        if ( !theme.isNull() ) {
+            for ( int size : SIZES )
+                m_suspended.addPixmap( theme.pixmap( size, size ) );
+        } else {
+            // The empty face, greyed like any disabled icon.
+            m_suspended = QIcon( frame( 0 ).pixmap( SIZES[1], QIcon::Disabled ) );
+        }
+    }
+    return m_suspended;
+}
+
+QIcon ProgressIcon::render( int index ) const
+{
+    QIcon icon;
+    for ( QPixmap pixmap : m_faces ) {
+        if ( index > 0 ) {
+            const qreal side = pixmap.width() / pixmap.devicePixelRatio();
+            // Stay inside the bezel of the face.
+            const QRectF dial = QRectF( 0, 0, side, side ).adjusted( side * 0.14, side * 0.14,
+                                                                     -side * 0.14, -side * 0.14 );
+            // Qt counts in 1/16th of a degree, counter clockwise from 3 o'clock.
+            const int span = -qRound( 360 * 16 * index / double( FRAME_COUNT - 1 ) );
+
+            QPainter p( &pixmap );
+            p.setRenderHint( QPainter::Antialiasing );
+            p.setPen( Qt::NoPen );
+            p.setBrush( QColor( 255, 255, 255, 150 ) );
+            p.drawPie( dial, 90 * 16, span );
+        }
+        icon.addPixmap( pixmap );
+    }
+    return icon;
+}
@@ -0,0 +1,59 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_PROGRESSICON_H
+#define RSIBREAK_PROGRESSICON_H
+
+#include <QIcon>
+#include <QPixmap>
+#include <QVector>
+
+/**
+ * @class ProgressIcon
+ * The tray icon, showing how far the time until the next tiny break has
+ * progressed as a wedge over the rsibreak clock face.
+ *
+ * The theme is asked for the face once. Every frame is rendered on first
+ * use in all tray sizes and kept, so the tray can be given pixmaps and the
+ * StatusNotifier host never has to look the icon up. Callers should only
+ * pass a frame on when frameFor() returns a different index.
+ */
+class ProgressIcon
+{
+public:
+    /** Number of distinct progress steps. */
+    static const int FRAME_COUNT = 48;
+
+    ProgressIcon();
+
+    /** @returns the index of the frame for @p progress, from 0 to 100. */
+    static int frameFor( double progress );
+
+    /** @returns frame @p index, rendering it when it is used for the first time. */
+    const QIcon& frame( int index );
+
+    /** @returns the icon shown while RSIBreak is suspended. */
+    const QIcon& suspended();
+
+private:
+    QIcon render( int index ) const;
+
+    QVector<QPixmap> m_faces;
+    QVector<QIcon> m_frames;
+    QIcon m_suspended;
+};
+
+#endif // RSIBREAK_PROGRESSICON_H
@@ -0,0 +1,53 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiactivitywindow.h"
+
+#include <algorithm>
+
+RSIActivityWindow::RSIActivityWindow( const int window, const int budget )
+    : m_ring( std::max( 1, window ), 0 )
+    , m_budget( budget )
+    , m_position( 0 )
+    , m_sum( 0 )
+{
+}
+
+bool RSIActivityWindow::tick( const bool active )
+{
+    const bool below = m_sum < m_budget;
+
+    // The oldest tick leaves the window as the new one enters.
+    quint8& slot = m_ring[m_position];
+    m_sum += ( active ? 1 : 0 ) - slot;
+    slot = active ? 1 : 0;
+    if ( ++m_position == m_ring.count() )
+        m_position = 0;
+
+    return below && m_sum >= m_budget;
+}
+
+int RSIActivityWindow::ticksLeft() const
+{
+    return std::max( 0, m_budget - m_sum );
+}
+
+void RSIActivityWindow::reset()
+{
+    m_ring.fill( 0 );
+    m_position = 0;
+    m_sum = 0;
+}
@@ -0,0 +1,56 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIACTIVITYWINDOW_H
+#define RSIBREAK_RSIACTIVITYWINDOW_H
+
+#include <QVector>
+
+// Counts the active ticks within the last `window` ticks, however they are
+// spread, to enforce rules like "at most 50 active minutes in any hour"
+// that short idle gaps do not get around.
+// A ring with one entry per tick and a running sum make a tick O(1).
+class RSIActivityWindow
+{
+public:
+    RSIActivityWindow( const int window, const int budget );
+
+    // Counts one tick.
+    // @param active whether the user was active during this tick.
+    // @returns true when the active ticks in the window reach the budget.
+    // It is not returned again before they dropped below it.
+    bool tick( const bool active );
+
+    // @returns the active ticks within the window.
+    int activeTicks() const { return m_sum; }
+
+    // @returns active ticks left before the budget is reached.
+    int ticksLeft() const;
+
+    int window() const { return m_ring.count(); }
+    int budget() const { return m_budget; }
+
+    // Forgets all activity.
+    void reset();
+
+private:
+    QVector<quint8> m_ring;
+    const int m_budget;
+    int m_position;
+    int m_sum;
+};
+
+#endif //RSIBREAK_RSIACTIVITYWINDOW_H
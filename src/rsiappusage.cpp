@@ -0,0 +1,195 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiappusage.h"
+
+#include <QDebug>
+
+#include <KConfigGroup>
+#include <KWindowInfo>
+#include <KWindowSystem>
+
+#include <algorithm>
+#include <iterator>
+
+// Saved this often, a crash loses at most as much.
+static const int SAVE_INTERVAL = 5 * 60 * 1000;
+
+static const int TABLE_SIZE = 2 * ( RSIAppUsage::CAPACITY + 1 );
+
+static const char* GROUP = "AppUsage";
+
+const int RSIAppUsage::CAPACITY;
+const int RSIAppUsage::KEEP_DAYS;
+
+RSIAppUsage::RSIAppUsage( QObject* parent )
+    : QObject( parent )
+    , m_day( QDate::currentDate() )
+{
+    clear();
+    // Also where a day that ends without a focus change is closed.
+    m_saveTimer.setInterval( SAVE_INTERVAL );
+    connect( &m_saveTimer, &QTimer::timeout, this, [this]() {
+        rollOver();
+        save();
+    } );
+    m_saveTimer.start();
+}
+
+RSIAppUsage::~RSIAppUsage()
+{
+    save();
+}
+
+void RSIAppUsage::setStorage( const KSharedConfig::Ptr& state )
+{
+    m_state = state;
+    if ( !m_state )
+        return;
+
+    // Carry on with the totals of an earlier run today.
+    const KConfigGroup day = m_state->group( GROUP ).group( m_day.toString( Qt::ISODate ) );
+    const QStringList applications = day.keyList();
+    for ( const QString& application : applications ) {
+        const int index = intern( application );
+        m_seconds[index].fetch_add( day.readEntry( application, 0 ), std::memory_order_relaxed );
+    }
+}
+
+void RSIAppUsage::watchActiveWindow()
+{
+    connect( KWindowSystem::self(), &KWindowSystem::activeWindowChanged,
+             this, &RSIAppUsage::slotActiveWindowChanged );
+    slotActiveWindowChanged();
+}
+
+void RSIAppUsage::slotActiveWindowChanged()
+{
+    const WId active = KWindowSystem::activeWindow();
+    if ( !active ) {
+        setActive( QString() );
+        return;
+    }
+
+    KWindowInfo info( active, NET::Properties(), NET::WM2WindowClass );
+    setActive( info.valid() ? QString::fromUtf8( info.windowClassClass() ) : QString() );
+}
+
+void RSIAppUsage::setActive( const QString& application )
+{
+    rollOver();
+    m_active.store( &m_seconds[intern( application )], std::memory_order_relaxed );
+}
+
+int RSIAppUsage::seconds( const QString& application ) const
+{
+    const int slot = find( application, qHash( application ) );
+    if ( application.isEmpty() || !m_table[slot] )
+        return 0;
+    return m_seconds[m_table[slot] - 1].load( std::memory_order_relaxed );
+}
+
+QVector<RSIAppUsage::Entry> RSIAppUsage::top( int count ) const
+{
+    QVector<Entry> entries;
+    entries.reserve( m_names.size() - 1 );
+    for ( int i = 1; i < m_names.size(); ++i ) {
+        const int seconds = m_seconds[i].load( std::memory_order_relaxed );
+        if ( seconds > 0 )
+            entries.append( Entry( m_names[i], seconds ) );
+    }
+
+    count = std::max( 0, std::min( count, entries.size() ) );
+    std::partial_sort( entries.begin(), entries.begin() + count, entries.end(),
+    []( const Entry & a, const Entry & b ) {
+        return a.second > b.second || ( a.second == b.second && a.first < b.first );
+    } );
+    entries.resize( count );
+    return entries;
+}
+
+void RSIAppUsage::save()
+{
+    if ( !m_state )
+        return;
+
+    KConfigGroup usage = m_state->group( GROUP );
+    KConfigGroup day = usage.group( m_day.toString( Qt::ISODate ) );
+    for ( int i = 1; i < m_names.size(); ++i ) {
+        const int seconds = m_seconds[i].load( std::memory_order_relaxed );
+        if ( seconds > 0 )
+            day.writeEntry( m_names[i], seconds );
+    }
+
+    const QStringList days = usage.groupList();
+    for ( const QString& name : days ) {
+        const QDate date = QDate::fromString( name, Qt::ISODate );
+        if ( !date.isValid() || date.daysTo( m_day ) >= KEEP_DAYS )
+            usage.deleteGroup( name );
+    }
+
+    if ( !m_state->sync() )
+        qWarning() << "Could not save the application usage to" << m_state->name();
+}
+
+int RSIAppUsage::find( const QString& name, uint hash ) const
+{
+    int slot = hash & ( TABLE_SIZE - 1 );
+    while ( m_table[slot] && m_names[m_table[slot] - 1] != name )
+        slot = ( slot + 1 ) & ( TABLE_SIZE - 1 );
+    return slot;
+}
+
+int RSIAppUsage::intern( const QString& name )
+{
+    if ( name.isEmpty() )
+        return 0;
+
+    const int slot = find( name, qHash( name ) );
+    if ( m_table[slot] )
+        return m_table[slot] - 1;
+    if ( m_names.size() > CAPACITY )
+        return 0;
+
+    m_names.append( name );
+    m_table[slot] = m_names.size();
+    return m_names.size() - 1;
+}
+
+void RSIAppUsage::clear()
+{
+    // A tick racing with this may still land on the old counter, one
+    // second at most goes to the wrong application.
+    m_active.store( &m_seconds[0], std::memory_order_relaxed );
+    m_names.clear();
+    m_names.append( QString() );
+    for ( std::atomic<quint32>& seconds : m_seconds )
+        seconds.store( 0, std::memory_order_relaxed );
+    std::fill( std::begin( m_table ), std::end( m_table ), 0 );
+}
+
+void RSIAppUsage::rollOver()
+{
+    const QDate today = QDate::currentDate();
+    if ( today == m_day )
+        return;
+
+    save();
+    const QString active = m_names[m_active.load( std::memory_order_relaxed ) - m_seconds];
+    clear();
+    m_day = today;
+    m_active.store( &m_seconds[intern( active )], std::memory_order_relaxed );
+}
@@ -0,0 +1,110 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIAPPUSAGE_H
+#define RSIBREAK_RSIAPPUSAGE_H
+
+#include <QDate>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <KSharedConfig>
+
+#include <atomic>
+
+/**
+ * @class RSIAppUsage
+ * Attributes active seconds to the application in focus, by window class.
+ *
+ * The focus is followed from activeWindowChanged() only, it is never
+ * polled. Every distinct class is interned once per day in a small open
+ * addressing table and owns a fixed counter, so the timer thread pays a
+ * single relaxed increment per active second and never allocates.
+ *
+ * The totals of a day are kept in a state file, apart from rsibreakrc,
+ * one group per date.
+ */
+class RSIAppUsage : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Seconds spent in one application.
+    typedef QPair<QString, int> Entry;
+
+    // Applications told apart in a day, the rest counts as unknown.
+    static const int CAPACITY = 255;
+
+    // Days of totals kept in the state file.
+    static const int KEEP_DAYS = 30;
+
+    explicit RSIAppUsage( QObject* parent = 0 );
+    ~RSIAppUsage();
+
+    /**
+     * Keeps the totals in @p state: today's are read back from it and
+     * written every few minutes and on exit. Without it they are only
+     * kept in memory.
+     */
+    void setStorage( const KSharedConfig::Ptr& state );
+
+    /** Follows the active window through KWindowSystem. */
+    void watchActiveWindow();
+
+    /** Counts an active second for the application in focus. Any thread. */
+    void tick() {
+        m_active.load( std::memory_order_relaxed )->fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    /** The application with window class @p application got the focus. */
+    void setActive( const QString& application );
+
+    /** @returns the seconds counted today for @p application. */
+    int seconds( const QString& application ) const;
+
+    /** @returns at most @p count applications of today, longest first. */
+    QVector<Entry> top( int count ) const;
+
+    /** Writes today's totals to the state file. */
+    void save();
+
+private slots:
+    void slotActiveWindowChanged();
+
+private:
+    // Slot of the table holding @p name, or the free one it would take.
+    int find( const QString& name, uint hash ) const;
+    int intern( const QString& name );
+    void clear();
+    void rollOver();
+
+    // Interned names and their counters, index 0 is kept for unknown.
+    QVector<QString> m_names;
+    std::atomic<quint32> m_seconds[CAPACITY + 1];
+    // Index + 1 into m_names, 0 for a free slot. Half full at most.
+    quint16 m_table[2 * ( CAPACITY + 1 )];
+
+    std::atomic<std::atomic<quint32>*> m_active;
+
+    QDate m_day;
+    KSharedConfig::Ptr m_state;
+    QTimer m_saveTimer;
+};
+
+#endif //RSIBREAK_RSIAPPUSAGE_H
@@ -0,0 +1,123 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsibreakschedules.h"
+
+#include <algorithm>
+
+int RSIBreakSchedules::add( Kind kind, int priority, int delay, int breakLength, int resetThreshold )
+{
+    Q_ASSERT( count() < MAX_SCHEDULES );
+    m_delay.append( delay );
+    m_breakLength.append( breakLength );
+    m_resetThreshold.append( resetThreshold );
+    m_counter.append( 0 );
+    m_priority.append( priority );
+    m_kind.append( kind );
+    return count() - 1;
+}
+
+void RSIBreakSchedules::set( int schedule, int delay, int breakLength, int resetThreshold )
+{
+    m_delay[schedule] = delay;
+    m_breakLength[schedule] = breakLength;
+    m_resetThreshold[schedule] = resetThreshold;
+    m_counter[schedule] = 0;
+}
+
+RSIBreakSchedules::Due RSIBreakSchedules::tick( int idleTime, int weight )
+{
+    Due due = { -1, 0, 0, 0 };
+
+    const int n = count();
+    int* counter = m_counter.data();
+    const int* delay = m_delay.constData();
+    const int* threshold = m_resetThreshold.constData();
+    const int step = idleTime == 0 ? weight : 1;
+
+    for ( int i = 0; i < n; ++i ) {
+        const int ticks = counter[i] += step;
+
+        // Not idle for too long, time for a break.
+        if ( ticks >= delay[i] ) {
+            counter[i] = 0;
+            due.dueMask |= 1u << i;
+            due.breakLength = std::max( due.breakLength, m_breakLength[i] );
+            if ( due.schedule < 0 || m_priority[i] > m_priority[due.schedule] )
+                due.schedule = i;
+            continue;
+        }
+
+        // Idle for enough to consider the break has happened. A schedule
+        // which was already reset does not count as skipped.
+        if ( idleTime >= threshold[i] ) {
+            counter[i] = 0;
+            if ( ticks > 1 )
+                due.idleReset |= 1u << i;
+        }
+    }
+
+    return due;
+}
+
+quint32 RSIBreakSchedules::credit( int idleTime )
+{
+    quint32 idleReset = 0;
+    for ( int i = 0; i < count(); ++i ) {
+        if ( idleTime >= m_resetThreshold[i] && m_counter[i] > 0 ) {
+            m_counter[i] = 0;
+            idleReset |= 1u << i;
+        }
+    }
+    return idleReset;
+}
+
+quint32 RSIBreakSchedules::defer( quint32 schedules, int idleTime )
+{
+    quint32 idleReset = 0;
+    for ( int i = 0; i < count(); ++i ) {
+        if ( ( schedules & ( 1u << i ) ) && idleTime >= m_resetThreshold[i] ) {
+            m_counter[i] = 0;
+            idleReset |= 1u << i;
+        }
+    }
+    postponeAll( schedules & ~idleReset, 1 );
+    return idleReset;
+}
+
+int RSIBreakSchedules::next() const
+{
+    int next = -1;
+    for ( int i = 0; i < count(); ++i ) {
+        if ( next < 0 || counterLeft( i ) < counterLeft( next ) ||
+                ( counterLeft( i ) == counterLeft( next ) && m_priority[i] > m_priority[next] ) )
+            next = i;
+    }
+    return next;
+}
+
+void RSIBreakSchedules::postpone( int schedule, int ticks )
+{
+    m_counter[schedule] = std::max( 0, m_delay[schedule] - ticks );
+}
+
+void RSIBreakSchedules::postponeAll( quint32 schedules, int ticks )
+{
+    for ( int i = 0; schedules != 0; ++i, schedules >>= 1 ) {
+        if ( schedules & 1 )
+            postpone( i, ticks );
+    }
+}
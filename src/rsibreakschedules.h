@@ -0,0 +1,107 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIBREAKSCHEDULES_H
+#define RSIBREAK_RSIBREAKSCHEDULES_H
+
+#include <QVector>
+
+// All break schedules of the timer, such as the tiny and the big break,
+// each counting ticks of activity like RSITimerCounter does. The fields
+// are kept in one array per field, so a tick is one pass over a few
+// small arrays however many schedules there are.
+class RSIBreakSchedules
+{
+public:
+    // Whether a break is announced and counted as a short or a long one.
+    enum Kind {
+        ShortBreak = 0,
+        LongBreak
+    };
+
+    // The result of tick().
+    struct Due {
+        int schedule;       // the schedule whose break wins, -1 if none is due.
+        int breakLength;    // ticks to break for, the longest of all due breaks.
+        quint32 dueMask;    // bit per schedule that fell due this tick.
+        quint32 idleReset;  // bit per schedule that idleness reset this tick.
+    };
+
+    // Schedules fit in Due::idleReset.
+    static const int MAX_SCHEDULES = 32;
+
+    // Adds a schedule and returns its index. When several breaks are due
+    // at once, the one with the highest @p priority wins.
+    int add( Kind kind, int priority, int delay, int breakLength, int resetThreshold );
+
+    // Changes the timings of @p schedule and resets it.
+    void set( int schedule, int delay, int breakLength, int resetThreshold );
+
+    int count() const { return m_delay.count(); }
+
+    // Counts one tick for all schedules.
+    // @param idleTime time idle for this tick.
+    // @param weight how many ticks an active tick counts for.
+    // @returns which break is due, all due schedules are reset. Breaks
+    // falling due together are merged into one of the longest length.
+    Due tick( int idleTime, int weight = 1 );
+
+    // Counts @p idleTime away from the computer, e.g. with the screen
+    // locked, as a break for all schedules whose threshold it reaches.
+    // Activity counted so far is kept for the others.
+    // @returns a bit per schedule that was reset.
+    quint32 credit( int idleTime );
+
+    // @returns the schedule whose break comes first from now on, ties go
+    // to the higher priority.
+    int next() const;
+
+    Kind kind( int schedule ) const { return m_kind[schedule]; }
+
+    // @returns ticks left till break for @p schedule.
+    int counterLeft( int schedule ) const { return m_delay[schedule] - m_counter[schedule]; }
+
+    // @returns ticks @p schedule delays for.
+    int delayTicks( int schedule ) const { return m_delay[schedule]; }
+
+    // @returns whether @p schedule was just reset.
+    bool isReset( int schedule ) const { return m_counter[schedule] == 0; }
+
+    void reset( int schedule ) { m_counter[schedule] = 0; }
+
+    // Postpones the break of @p schedule to `ticks` ticks from now.
+    void postpone( int schedule, int ticks );
+
+    // Postpones the breaks of all schedules in the mask @p schedules, such
+    // as Due::dueMask, so breaks due together stay merged.
+    void postponeAll( quint32 schedules, int ticks );
+
+    // Keeps the due @p schedules due on the next tick, except those whose
+    // threshold @p idleTime reaches: the break counts as taken and they
+    // are reset instead.
+    // @returns a bit per schedule that was reset.
+    quint32 defer( quint32 schedules, int idleTime );
+
+private:
+    QVector<int> m_delay;
+    QVector<int> m_breakLength;
+    QVector<int> m_resetThreshold;
+    QVector<int> m_counter;     // counts ticks of user activity.
+    QVector<int> m_priority;
+    QVector<Kind> m_kind;
+};
+
+#endif //RSIBREAK_RSIBREAKSCHEDULES_H
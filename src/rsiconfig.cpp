@@ -0,0 +1,129 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiconfig.h"
+
+#include <QDebug>
+
+#include <KConfig>
+#include <KConfigGroup>
+
+RSIConfig::RSIConfig()
+    : intervals( INTERVAL_COUNT )
+    , usePopup( true )
+    , useIdleTimers( true )
+    , useInputIntensity( false )
+    , useFlash( true )
+    , hideMinimizeButton( false )
+    , hideLockButton( false )
+    , hidePostponeButton( false )
+    , disableAccel( false )
+    , effect( 0 )
+    , grayLevel( 80 )
+    , usePlasmaReadOnly( false )
+    , slideInterval( 10 )
+    , searchRecursive( false )
+    , showSmallImages( true )
+    , expandImageToFullScreen( true )
+{
+    intervals[TINY_BREAK_INTERVAL] = 10 * 60;
+    intervals[TINY_BREAK_DURATION] = 20;
+    intervals[TINY_BREAK_THRESHOLD] = 20;
+    intervals[BIG_BREAK_INTERVAL] = 60 * 60;
+    intervals[BIG_BREAK_DURATION] = 1 * 60;
+    intervals[BIG_BREAK_THRESHOLD] = 1 * 60;
+    intervals[POSTPONE_BREAK_INTERVAL] = 5 * 60;
+    intervals[PATIENCE_INTERVAL] = 30;
+    intervals[ACTIVITY_WINDOW] = 60 * 60;
+    intervals[ACTIVITY_BUDGET] = 0;
+}
+
+RSIConfig RSIConfig::read( const KConfig& kconfig )
+{
+    RSIConfig c;
+
+    const KConfigGroup config = kconfig.group( "General Settings" );
+    c.intervals[TINY_BREAK_INTERVAL] = config.readEntry( "TinyInterval", 10 ) * 60;
+    c.intervals[TINY_BREAK_DURATION] = config.readEntry( "TinyDuration", 20 );
+    c.intervals[TINY_BREAK_THRESHOLD] = config.readEntry( "TinyThreshold", 20 );
+    c.intervals[BIG_BREAK_INTERVAL] = config.readEntry( "BigInterval", 60 ) * 60;
+    c.intervals[BIG_BREAK_DURATION] = config.readEntry( "BigDuration", 1 ) * 60;
+    c.intervals[BIG_BREAK_THRESHOLD] = config.readEntry( "BigThreshold", 1 ) * 60;
+    c.intervals[POSTPONE_BREAK_INTERVAL] = config.readEntry( "PostponeBreakDuration", 5 ) * 60;
+    c.intervals[PATIENCE_INTERVAL] = config.readEntry( "Patience", 30 );
+    c.intervals[ACTIVITY_WINDOW] = config.readEntry( "ActivityWindow", 60 ) * 60;
+    c.intervals[ACTIVITY_BUDGET] = config.readEntry( "ActivityBudget", 0 ) * 60;
+
+    if ( config.readEntry( "DEBUG", 0 ) > 0 ) {
+        qDebug() << "Debug mode activated";
+        c.intervals[TINY_BREAK_INTERVAL] = c.intervals[TINY_BREAK_INTERVAL] / 60;
+        c.intervals[BIG_BREAK_INTERVAL] = c.intervals[BIG_BREAK_INTERVAL] / 60;
+        c.intervals[BIG_BREAK_DURATION] = c.intervals[BIG_BREAK_DURATION] / 60;
+        c.intervals[POSTPONE_BREAK_INTERVAL] = c.intervals[POSTPONE_BREAK_INTERVAL] / 60;
+        c.intervals[ACTIVITY_WINDOW] = c.intervals[ACTIVITY_WINDOW] / 60;
+        c.intervals[ACTIVITY_BUDGET] = c.intervals[ACTIVITY_BUDGET] / 60;
+    }
+
+    c.useIdleTimers = !config.readEntry( "UseNoIdleTimer", false );
+    c.useInputIntensity = config.readEntry( "UseInputIntensity", false );
+
+    c.hideMinimizeButton = config.readEntry( "HideMinimizeButton", false );
+    c.hideLockButton = config.readEntry( "HideLockButton", false );
+    c.hidePostponeButton = config.readEntry( "HidePostponeButton", false );
+    c.disableAccel = config.readEntry( "DisableAccel", false );
+
+    c.effect = config.readEntry( "Effect", 0 );
+    c.grayLevel = config.readEntry( "Graylevel", 80 );
+    c.usePlasmaReadOnly = config.readEntry( "UsePlasmaReadOnly", false );
+    c.imageFolder = config.readEntry( "ImageFolder" );
+    c.slideInterval = config.readEntry( "SlideInterval", 10 );
+    c.searchRecursive = config.readEntry( "SearchRecursiveCheck", false );
+    c.showSmallImages = config.readEntry( "ShowSmallImagesCheck", true );
+    c.expandImageToFullScreen = config.readEntry( "ExpandImageToFullScreen", true );
+
+    const KConfigGroup popup = kconfig.group( "Popup Settings" );
+    c.usePopup = popup.readEntry( "UsePopup", true );
+    c.useFlash = popup.readEntry( "UseFlash", true );
+
+    return c;
+}
+
+RSIConfig::Changes RSIConfig::diff( const RSIConfig& o ) const
+{
+    Changes changes = NoChange;
+
+    if ( intervals != o.intervals || usePopup != o.usePopup || useIdleTimers != o.useIdleTimers ||
+            useInputIntensity != o.useInputIntensity )
+        changes |= TimerChanged;
+
+    if ( useFlash != o.useFlash )
+        changes |= RelaxPopupChanged;
+
+    if ( hideMinimizeButton != o.hideMinimizeButton || hideLockButton != o.hideLockButton ||
+            hidePostponeButton != o.hidePostponeButton || disableAccel != o.disableAccel )
+        changes |= ButtonsChanged;
+
+    if ( effect != o.effect || usePlasmaReadOnly != o.usePlasmaReadOnly ||
+            imageFolder != o.imageFolder || slideInterval != o.slideInterval ||
+            searchRecursive != o.searchRecursive || showSmallImages != o.showSmallImages ||
+            expandImageToFullScreen != o.expandImageToFullScreen )
+        changes |= EffectChanged;
+
+    if ( grayLevel != o.grayLevel )
+        changes |= GrayLevelChanged;
+
+    return changes;
+}
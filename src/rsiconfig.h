@@ -0,0 +1,100 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSICONFIG_H
+#define RSICONFIG_H
+
+#include <QFlags>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+class KConfig;
+
+enum RSIInterval {
+    TINY_BREAK_INTERVAL = 0,
+    TINY_BREAK_DURATION,
+    TINY_BREAK_THRESHOLD,
+    BIG_BREAK_INTERVAL,
+    BIG_BREAK_DURATION,
+    BIG_BREAK_THRESHOLD,
+    POSTPONE_BREAK_INTERVAL,
+    PATIENCE_INTERVAL,
+    ACTIVITY_WINDOW,
+    ACTIVITY_BUDGET,
+    INTERVAL_COUNT
+};
+
+/**
+ * @class RSIConfig
+ * All settings of rsibreakrc, read in one go. Comparing two snapshots
+ * tells which parts of the application have to pick up a change, so
+ * accepting the settings dialog does not rebuild what did not change.
+ */
+class RSIConfig
+{
+public:
+    enum Change {
+        NoChange = 0,
+        TimerChanged = 1 << 0,      ///< intervals, popup, idle detection or intensity
+        RelaxPopupChanged = 1 << 1, ///< flashing of the relax popup
+        ButtonsChanged = 1 << 2,    ///< buttons and shortcut of the break screens
+        EffectChanged = 1 << 3,     ///< the effect or settings it is created with
+        GrayLevelChanged = 1 << 4,  ///< only the gray level of the gray effect
+        AllChanged = 0xff
+    };
+    Q_DECLARE_FLAGS( Changes, Change )
+
+    /** The defaults, as used when rsibreakrc is empty. */
+    RSIConfig();
+
+    /** Reads all settings from @p config. */
+    static RSIConfig read( const KConfig& config );
+
+    /** @returns what differs between this snapshot and @p other. */
+    Changes diff( const RSIConfig& other ) const;
+
+    // Timer, in seconds, indexed by RSIInterval.
+    QVector<int> intervals;
+    bool usePopup;
+    bool useIdleTimers;
+    // Count active time faster while typing and clicking intensely.
+    bool useInputIntensity;
+
+    // Relax popup.
+    bool useFlash;
+
+    // Break screens.
+    bool hideMinimizeButton;
+    bool hideLockButton;
+    bool hidePostponeButton;
+    bool disableAccel;
+
+    // Effect.
+    int effect;
+    int grayLevel;
+    bool usePlasmaReadOnly;
+    QString imageFolder;
+    int slideInterval;
+    bool searchRecursive;
+    bool showSmallImages;
+    bool expandImageToFullScreen;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS( RSIConfig::Changes )
+Q_DECLARE_METATYPE( RSIConfig )
+
+#endif // RSICONFIG_H
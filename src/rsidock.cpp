@@ -39,6 +39,7 @@
 #include <KMessageBox>
 #include <KWindowSystem>
 #include <KConfigGroup>
+#include <KSharedConfig>
 #include <QDialogButtonBox>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -62,6 +63,7 @@ static QAction *doAddAction(QMenu *menu, const QIcon &icon, const QString &text,
 
 RSIDock::RSIDock( QObject *parent )
         : KStatusNotifierItem( parent ), m_suspended( false )
+        , m_shownTinyLeft( INT_MAX ), m_shownBigLeft( INT_MAX )
         , m_statsDialog( 0 ), m_statsWidget( 0 )
 {
     setCategory(ApplicationStatus);
@@ -122,6 +124,9 @@ void RSIDock::slotConfigureNotifications()
 
 void RSIDock::slotConfigure()
 {
+    // rsibreakrc may have been edited by hand since it was last read.
+    KSharedConfig::openConfig()->reparseConfiguration();
+
     // don't think it is needed, because setup is not accessed after the
     // exec call, but better safe than crash.
     QPointer<Setup> setup = new Setup( 0 );
@@ -209,38 +214,63 @@ static QString colorizedText( const QString& text, const QColor& color )
         ;
 }
 
+// The tooltip counts down in whole minutes, rounded up, until the last
+// minute, so its text and colours only change once a minute.
+static int shownSeconds( int seconds )
+{
+    return seconds > 60 ? ( seconds + 59 ) / 60 * 60 : seconds;
+}
+
 void RSIDock::setCounters( int tiny_left, int big_left )
 {
-    if ( m_suspended )
-        setToolTipSubTitle( i18n( "Suspended" ) );
-    else {
-        QColor tinyColor = RSIGlobals::instance()->getTinyBreakColor( tiny_left );
-        RSIGlobals::instance()->stats()->setColor( LAST_TINY_BREAK, tinyColor );
-
-        QColor bigColor = RSIGlobals::instance()-> getBigBreakColor( big_left );
-        RSIGlobals::instance()->stats()->setColor( LAST_BIG_BREAK, bigColor );
-
-        // Only add the line for the tiny break when there is not
-        // a big break planned at the same time.
-
-        QStringList lines;
-        if ( tiny_left != big_left ) {
-            QString formattedText = RSIGlobals::instance()->formatSeconds( tiny_left );
-            if ( !formattedText.isNull() ) {
-                lines << colorizedText(
-                    i18n( "%1 remaining until next short break", formattedText ),
-                    tinyColor
-                    );
-            }
-        }
+    if ( m_suspended ) {
+        // Build the text again on the first update after resuming.
+        m_shownTinyLeft = m_shownBigLeft = INT_MAX;
+        setToolTipText( i18n( "Suspended" ) );
+        return;
+    }
 
-        // do the same for the big break
-        if ( big_left > 0 )
+    // Only add the line for the tiny break when there is not
+    // a big break planned at the same time.
+    const int shownTinyLeft = tiny_left != big_left ? shownSeconds( tiny_left ) : INT_MIN;
+    const int shownBigLeft = big_left > 0 ? shownSeconds( big_left ) : INT_MIN;
+    if ( shownTinyLeft == m_shownTinyLeft && shownBigLeft == m_shownBigLeft )
+        return;
+    m_shownTinyLeft = shownTinyLeft;
+    m_shownBigLeft = shownBigLeft;
+
+    QColor tinyColor = RSIGlobals::instance()->getTinyBreakColor( shownSeconds( tiny_left ) );
+    RSIGlobals::instance()->stats()->setColor( LAST_TINY_BREAK, tinyColor );
+
+    QColor bigColor = RSIGlobals::instance()->getBigBreakColor( shownSeconds( big_left ) );
+    RSIGlobals::instance()->stats()->setColor( LAST_BIG_BREAK, bigColor );
+
+    QStringList lines;
+    if ( shownTinyLeft != INT_MIN ) {
+        QString formattedText = RSIGlobals::instance()->formatSeconds( shownTinyLeft );
+        if ( !formattedText.isNull() ) {
             lines << colorizedText(
-                i18n( "%1 remaining until next long break",
-                    RSIGlobals::instance()->formatSeconds( big_left ) ),
-                bigColor
+                i18n( "%1 remaining until next short break", formattedText ),
+                tinyColor
                 );
-        setToolTipSubTitle(lines.join("<br>"));
+        }
     }
+
+    // do the same for the big break
+    if ( shownBigLeft != INT_MIN )
+        lines << colorizedText(
+            i18n( "%1 remaining until next long break",
+                RSIGlobals::instance()->formatSeconds( shownBigLeft ) ),
+            bigColor
+            );
+    setToolTipText( lines.join( "<br>" ) );
+}
+
+void RSIDock::setToolTipText( const QString& text )
+{
+    // Every change is a D-Bus signal to the tray host, send only real ones.
+    if ( text == m_toolTipText )
+        return;
+    m_toolTipText = text;
+    setToolTipSubTitle( text );
 }
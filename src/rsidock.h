@@ -102,6 +102,8 @@ private slots:
     void slotResetStats();
 
 private:
+    void setToolTipText( const QString& text );
+
     KHelpMenu*    m_help;
 
     QAction* m_suspendItem;
@@ -109,6 +111,11 @@ private:
 
     QDialog *m_statsDialog;
     RSIStatWidget *m_statsWidget;
+
+    // What the tooltip shows, INT_MIN for a hidden line.
+    int m_shownTinyLeft;
+    int m_shownBigLeft;
+    QString m_toolTipText;
 };
 
 #endif // RSIDOCK_H
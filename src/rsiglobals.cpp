@@ -19,22 +19,27 @@
 
 #include "rsiglobals.h"
 
-#include <qdebug.h>
-#include <kconfig.h>
 #include <klocalizedstring.h>
 #include <knotification.h>
-#include <kconfiggroup.h>
 #include <ksharedconfig.h>
 
 #include <math.h>
 
+#include "rsiappusage.h"
 #include "rsistats.h"
 
+// Enough for every second of the longest break and the tooltip minutes.
+static const int FORMAT_CACHE_SIZE = 512;
+
 RSIGlobals *RSIGlobals::m_instance = 0;
 RSIStats *RSIGlobals::m_stats = 0;
+RSIAppUsage *RSIGlobals::m_appUsage = 0;
 
 RSIGlobals::RSIGlobals( QObject *parent )
         : QObject( parent )
+        , m_config( std::make_shared<const RSIConfig>() )
+        , m_configVersion( 0 )
+        , m_formatCache( FORMAT_CACHE_SIZE )
 {
     resetUsage();
     slotReadConfig();
@@ -44,6 +49,8 @@ RSIGlobals::~RSIGlobals()
 {
     delete m_stats;
     m_stats = 0L;
+    delete m_appUsage;
+    m_appUsage = 0L;
 }
 
 RSIGlobals *RSIGlobals::instance()
@@ -51,6 +58,7 @@ RSIGlobals *RSIGlobals::instance()
     if ( !m_instance ) {
         m_instance = new RSIGlobals();
         m_stats = new RSIStats();
+        m_appUsage = new RSIAppUsage();
     }
 
     return m_instance;
@@ -58,35 +66,36 @@ RSIGlobals *RSIGlobals::instance()
 
 QString RSIGlobals::formatSeconds( const int seconds )
 {
-    return m_format.formatSpelloutDuration( seconds * 1000 );
+    const QLocale locale;
+    if ( locale != m_formatLocale ) {
+        m_formatLocale = locale;
+        m_format = KFormat( locale );
+        m_formatCache.clear();
+    }
+
+    if ( const QString* cached = m_formatCache.object( seconds ) )
+        return *cached;
+
+    const QString text = m_format.formatSpelloutDuration( seconds * 1000 );
+    m_formatCache.insert( seconds, new QString( text ) );
+    return text;
 }
 
 void RSIGlobals::slotReadConfig()
 {
-    KConfigGroup config = KSharedConfig::openConfig()->group( "General Settings" );
-
-    m_intervals.resize(INTERVAL_COUNT);
-    m_intervals[TINY_BREAK_INTERVAL] = config.readEntry( "TinyInterval", 10 ) * 60;
-    m_intervals[TINY_BREAK_DURATION] = config.readEntry( "TinyDuration", 20 );
-    m_intervals[TINY_BREAK_THRESHOLD] = config.readEntry( "TinyThreshold", 20 );
-    m_intervals[BIG_BREAK_INTERVAL] = config.readEntry( "BigInterval", 60 ) * 60;
-    m_intervals[BIG_BREAK_DURATION] = config.readEntry( "BigDuration", 1 ) * 60;
-    m_intervals[BIG_BREAK_THRESHOLD] = config.readEntry( "BigThreshold", 1 ) * 60;
-    m_intervals[POSTPONE_BREAK_INTERVAL] = config.readEntry( "PostponeBreakDuration", 5 ) * 60;
-    m_intervals[PATIENCE_INTERVAL] = config.readEntry( "Patience", 30 );
-
-    if ( config.readEntry( "DEBUG", 0 ) > 0 ) {
-        qDebug() << "Debug mode activated";
-        m_intervals[TINY_BREAK_INTERVAL] = m_intervals[TINY_BREAK_INTERVAL] / 60;
-        m_intervals[BIG_BREAK_INTERVAL] = m_intervals[BIG_BREAK_INTERVAL] / 60;
-        m_intervals[BIG_BREAK_DURATION] = m_intervals[BIG_BREAK_DURATION] / 60;
-        m_intervals[POSTPONE_BREAK_INTERVAL] = m_intervals[POSTPONE_BREAK_INTERVAL] / 60;
-    }
+    setConfig( RSIConfig::read( *KSharedConfig::openConfig() ) );
+}
+
+void RSIGlobals::setConfig( const RSIConfig &config )
+{
+    // Readers check the version first, so the snapshot is stored before it.
+    std::atomic_store( &m_config, std::make_shared<const RSIConfig>( config ) );
+    m_configVersion.fetch_add( 1, std::memory_order_release );
 }
 
 QColor RSIGlobals::getTinyBreakColor( int secsToBreak ) const
 {
-    int minimized = m_intervals[TINY_BREAK_INTERVAL];
+    int minimized = config()->intervals[TINY_BREAK_INTERVAL];
     double v = 100 * secsToBreak / ( double )minimized;
 
     v = v > 100 ? 100 : v;
@@ -97,7 +106,7 @@ QColor RSIGlobals::getTinyBreakColor( int secsToBreak ) const
 
 QColor RSIGlobals::getBigBreakColor( int secsToBreak ) const
 {
-    int minimized = m_intervals[BIG_BREAK_INTERVAL];
+    int minimized = config()->intervals[BIG_BREAK_INTERVAL];
     double v = 100 * secsToBreak / ( double )minimized;
 
     v = v > 100 ? 100 : v;
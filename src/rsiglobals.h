@@ -20,13 +20,21 @@
 #define RSIGLOBALS_H
 
 #include <QBitArray>
+#include <QCache>
+#include <QLocale>
 #include <qmap.h>
 #include <QObject>
 #include <QStringList>
 
+#include <atomic>
+#include <memory>
+
 #include <kformat.h>
 #include <kpassivepopup.h>
 
+#include "rsiconfig.h"
+
+class RSIAppUsage;
 class RSIStats;
 
 enum RSIStat {
@@ -50,21 +58,13 @@ enum RSIStat {
     BIG_BREAKS_POSTPONED,
     LAST_BIG_BREAK,
     PAUSE_SCORE,
+    KEYSTROKES,
+    KEYSTROKES_PER_MINUTE,
+    MOUSE_CLICKS,
+    MOUSE_TRAVEL,
     STAT_COUNT
 };
 
-enum RSIInterval {
-    TINY_BREAK_INTERVAL = 0,
-    TINY_BREAK_DURATION,
-    TINY_BREAK_THRESHOLD,
-    BIG_BREAK_INTERVAL,
-    BIG_BREAK_DURATION,
-    BIG_BREAK_THRESHOLD,
-    POSTPONE_BREAK_INTERVAL,
-    PATIENCE_INTERVAL,
-    INTERVAL_COUNT
-};
-
 /**
  * @class RSIGlobals
  * This class consists of a few commonly used routines and values.
@@ -97,21 +97,56 @@ public:
     }
 
     /**
-     * Converts @p seconds to a reasonable string.
+     * Returns the active time per application.
+     *
+     * @see RSIAppUsage
+     */
+    static RSIAppUsage *appUsage() {
+        return m_appUsage;
+    }
+
+    /**
+     * Converts @p seconds to a reasonable string. The tray, the relax popup
+     * and the break screens ask for the same countdown values over and
+     * over, so the strings are kept in a small LRU cache which is dropped
+     * when the locale changes.
      * @param seconds the amount of seconds
      * @returns a formatted string.
      */
     QString formatSeconds( const int seconds );
 
     /**
-     * Returns a reference to the mapping containing all intervals.
+     * Returns a copy of the intervals of the current config() snapshot.
      * These intervals define when a tiny or big break should occur and for how
      * long.
      */
-    const QVector<int> &intervals() const {
-        return m_intervals;
+    QVector<int> intervals() const {
+        return config()->intervals;
+    }
+
+    /**
+     * The settings last read from rsibreakrc. The snapshot never changes,
+     * a new one is published instead, so it can be kept and read without
+     * locking for as long as needed.
+     */
+    std::shared_ptr<const RSIConfig> config() const {
+        return std::atomic_load( &m_config );
+    }
+
+    /**
+     * Increases with every published snapshot. Comparing it with the version
+     * a snapshot was taken at is a cheap way to see whether it is outdated.
+     */
+    quint64 configVersion() const {
+        return m_configVersion.load( std::memory_order_acquire );
     }
 
+    /**
+     * Publishes @p config, which RSIObject has already read, as the new
+     * snapshot, so rsibreakrc is parsed once per change.
+     */
+    void setConfig( const RSIConfig &config );
+
     /**
      * This function returns a color ranging from green to red.
      * The more red, the more the user needs a tiny break.
@@ -152,16 +187,20 @@ public:
 
 public slots:
     /**
-     * Reads the configuration.
+     * Reads the configuration from rsibreakrc.
      */
     void slotReadConfig();
 
 private:
     static RSIGlobals *m_instance;
     static RSIStats *m_stats;
-    QVector<int> m_intervals;
+    static RSIAppUsage *m_appUsage;
+    std::shared_ptr<const RSIConfig> m_config;
+    std::atomic<quint64> m_configVersion;
     QBitArray m_usageArray;
     KFormat m_format;
+    QLocale m_formatLocale;
+    QCache<int, QString> m_formatCache;
 };
 
 #endif // RSIGLOBALS_H
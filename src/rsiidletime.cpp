@@ -16,6 +16,53 @@
 
 #include "rsiidletime.h"
 
+#ifdef HAVE_XSYNC
+#include "rsiidletimexsync.h"
+#endif
+#ifdef HAVE_WAYLAND_IDLE_NOTIFY
+#include "rsiidletimewayland.h"
+#endif
+#ifdef HAVE_EVDEV
+#include "rsiidletimeevdev.h"
+#endif
+
+#include <QGuiApplication>
+
+#include <chrono>
+
+std::unique_ptr<RSIIdleTime> RSIIdleTime::create()
+{
+    const QString platform = QGuiApplication::platformName();
+#ifdef HAVE_XSYNC
+    if ( platform == QLatin1String( "xcb" ) ) {
+        std::unique_ptr<RSIIdleTimeXSync> xsync { new RSIIdleTimeXSync() };
+        if ( xsync->start() )
+            return xsync;
+    }
+#endif
+#ifdef HAVE_WAYLAND_IDLE_NOTIFY
+    if ( platform.startsWith( QLatin1String( "wayland" ) ) ) {
+        std::unique_ptr<RSIIdleTimeWayland> wayland { new RSIIdleTimeWayland() };
+        if ( wayland->start() )
+            return wayland;
+    }
+#endif
+#ifdef HAVE_EVDEV
+    // Kiosk shells on eglfs or linuxfb, KIdleTime has nothing to ask there.
+    if ( platform != QLatin1String( "xcb" ) && !platform.startsWith( QLatin1String( "wayland" ) ) ) {
+        std::unique_ptr<RSIIdleTimeEvdev> evdev { new RSIIdleTimeEvdev() };
+        if ( evdev->start() )
+            return evdev;
+    }
+#endif
+    return std::unique_ptr<RSIIdleTime> { new RSIIdleTimeImpl() };
+}
+
+qint64 RSIIdleTime::now()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>( steady_clock::now().time_since_epoch() ).count();
+}
 
 int RSIIdleTimeImpl::getIdleTime() const
 {
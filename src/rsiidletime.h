@@ -19,11 +19,23 @@
 
 #include <KIdleTime/KIdleTime>
 
+#include <memory>
+
 class RSIIdleTime
 {
 public:
     virtual ~RSIIdleTime() = default;
+    // @returns milliseconds since the last input.
     virtual int getIdleTime() const = 0;
+
+    // @returns the event driven backend for this session when there is
+    // one, KIdleTime otherwise.
+    static std::unique_ptr<RSIIdleTime> create();
+
+protected:
+    // @returns milliseconds of a steady clock, for the event driven
+    // backends to stamp the last input with.
+    static qint64 now();
 };
 
 class RSIIdleTimeImpl : public RSIIdleTime
@@ -0,0 +1,214 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimeevdev.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <linux/input.h>
+
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace
+{
+
+// Events read at once from one device.
+const int EVENT_BATCH = 64;
+const int EPOLL_BATCH = 16;
+
+bool testBit( const unsigned long* bits, int bit )
+{
+    const int width = 8 * sizeof( unsigned long );
+    return bits[bit / width] & ( 1UL << ( bit % width ) );
+}
+
+}
+
+RSIIdleTimeEvdev::RSIIdleTimeEvdev( const QString& directory )
+    : m_directory( directory )
+    , m_epoll( -1 )
+    , m_inotify( -1 )
+    , m_wake( -1 )
+    , m_lastInput( now() )
+{
+}
+
+RSIIdleTimeEvdev::~RSIIdleTimeEvdev()
+{
+    if ( m_thread.joinable() ) {
+        const quint64 stop = 1;
+        if ( write( m_wake, &stop, sizeof( stop ) ) < 0 )
+            qWarning() << "Could not stop the evdev thread";
+        m_thread.join();
+    }
+    foreach( int fd, m_devices )
+        close( fd );
+    if ( m_wake >= 0 )
+        close( m_wake );
+    if ( m_inotify >= 0 )
+        close( m_inotify );
+    if ( m_epoll >= 0 )
+        close( m_epoll );
+}
+
+bool RSIIdleTimeEvdev::start()
+{
+    m_epoll = epoll_create1( EPOLL_CLOEXEC );
+    m_wake = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    m_inotify = inotify_init1( IN_CLOEXEC | IN_NONBLOCK );
+    if ( m_epoll < 0 || m_wake < 0 || m_inotify < 0 )
+        return false;
+
+    // Devices show up with IN_CREATE, but are often readable only once udev
+    // changed their permissions.
+    if ( inotify_add_watch( m_inotify, QFile::encodeName( m_directory ).constData(), IN_CREATE | IN_ATTRIB ) < 0 ) {
+        qDebug() << "Cannot watch" << m_directory << "for input devices";
+        return false;
+    }
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wake;
+    epoll_ctl( m_epoll, EPOLL_CTL_ADD, m_wake, &ev );
+    ev.data.fd = m_inotify;
+    epoll_ctl( m_epoll, EPOLL_CTL_ADD, m_inotify, &ev );
+
+    foreach( const QString& name, QDir( m_directory ).entryList( QStringList() << QStringLiteral( "event*" ), QDir::System ) )
+        openDevice( name );
+    if ( m_devices.isEmpty() ) {
+        qDebug() << "No readable input device in" << m_directory;
+        return false;
+    }
+
+    m_lastInput = now();
+    m_thread = std::thread( &RSIIdleTimeEvdev::run, this );
+    return true;
+}
+
+int RSIIdleTimeEvdev::getIdleTime() const
+{
+    const qint64 idle = now() - m_lastInput.load( std::memory_order_relaxed );
+    return int( qBound<qint64>( 0, idle, INT_MAX ) );
+}
+
+void RSIIdleTimeEvdev::openDevice( const QString& name )
+{
+    if ( !name.startsWith( QLatin1String( "event" ) ) || m_devices.contains( name ) )
+        return;
+
+    const QByteArray path = QFile::encodeName( m_directory + QLatin1Char( '/' ) + name );
+    const int fd = open( path.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+    if ( fd < 0 )
+        return;
+
+    // Only keys, buttons, pointers and touch are input of the user, not
+    // switches such as the lid or the events of a sound card.
+    unsigned long types[EV_MAX / ( 8 * sizeof( unsigned long ) ) + 1] = { 0 };
+    if ( ioctl( fd, EVIOCGBIT( 0, sizeof( types ) ), types ) < 0 ||
+            !( testBit( types, EV_KEY ) || testBit( types, EV_REL ) || testBit( types, EV_ABS ) ) ) {
+        close( fd );
+        return;
+    }
+
+    // An accelerometer reports the device moving, not the user.
+    unsigned long props[INPUT_PROP_MAX / ( 8 * sizeof( unsigned long ) ) + 1] = { 0 };
+    if ( ioctl( fd, EVIOCGPROP( sizeof( props ) ), props ) >= 0 && testBit( props, INPUT_PROP_ACCELEROMETER ) ) {
+        close( fd );
+        return;
+    }
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if ( epoll_ctl( m_epoll, EPOLL_CTL_ADD, fd, &ev ) < 0 ) {
+        close( fd );
+        return;
+    }
+    m_devices.insert( name, fd );
+}
+
+void RSIIdleTimeEvdev::readDevice( int fd )
+{
+    input_event events[EVENT_BATCH];
+    bool input = false;
+
+    for ( ;; ) {
+        const ssize_t size = read( fd, events, sizeof( events ) );
+        if ( size < 0 && errno == EINTR )
+            continue;
+        if ( size <= 0 ) {
+            // The device was unplugged, closing also takes it out of epoll.
+            if ( size == 0 || errno == ENODEV ) {
+                close( fd );
+                m_devices.remove( m_devices.key( fd ) );
+            }
+            break;
+        }
+        for ( int i = 0; i < int( size / sizeof( input_event ) ) && !input; ++i )
+            input = events[i].type == EV_KEY || events[i].type == EV_REL || events[i].type == EV_ABS;
+    }
+
+    if ( input )
+        m_lastInput.store( now(), std::memory_order_relaxed );
+}
+
+void RSIIdleTimeEvdev::readHotplug()
+{
+    alignas( inotify_event ) char buffer[4096];
+    ssize_t size;
+    while ( ( size = read( m_inotify, buffer, sizeof( buffer ) ) ) > 0 ) {
+        for ( char* p = buffer; p < buffer + size; ) {
+            const inotify_event* ev = reinterpret_cast<const inotify_event*>( p );
+            if ( ev->len > 0 )
+                openDevice( QFile::decodeName( ev->name ) );
+            p += sizeof( inotify_event ) + ev->len;
+        }
+    }
+}
+
+void RSIIdleTimeEvdev::run()
+{
+    epoll_event events[EPOLL_BATCH];
+
+    for ( ;; ) {
+        const int count = epoll_wait( m_epoll, events, EPOLL_BATCH, -1 );
+        if ( count < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            qWarning() << "Waiting for input failed, the user counts as active";
+            m_lastInput.store( LLONG_MAX, std::memory_order_relaxed );
+            return;
+        }
+        for ( int i = 0; i < count; ++i ) {
+            const int fd = events[i].data.fd;
+            if ( fd == m_wake )
+                return;
+            if ( fd == m_inotify )
+                readHotplug();
+            else
+                readDevice( fd );
+        }
+    }
+}
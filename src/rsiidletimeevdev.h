@@ -0,0 +1,65 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIIDLETIMEEVDEV_H
+#define RSIBREAK_RSIIDLETIMEEVDEV_H
+
+#include "rsiidletime.h"
+
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+
+// Idle time read straight from the evdev devices in /dev/input, for kiosk
+// seats without an X server or a compositor that reports idleness. One
+// epoll thread reads all devices, a batch of events stores the time of
+// the last input once. Devices plugged in later are picked up through
+// inotify on the directory. Reading the devices needs the input group.
+class RSIIdleTimeEvdev : public RSIIdleTime
+{
+public:
+    explicit RSIIdleTimeEvdev( const QString& directory = QStringLiteral( "/dev/input" ) );
+    ~RSIIdleTimeEvdev() override;
+
+    // Opens the devices and starts the thread.
+    // @returns false when no device could be opened.
+    bool start();
+
+    int getIdleTime() const override;
+
+private:
+    void run();
+    void openDevice( const QString& name );
+    void readDevice( int fd );
+    void readHotplug();
+
+    const QString m_directory;
+    int m_epoll;
+    int m_inotify;
+    // Written to stop the thread.
+    int m_wake;
+    // Open devices by file name, only touched by the thread once started.
+    QHash<QString, int> m_devices;
+    std::thread m_thread;
+
+    // Monotonic time in ms of the last input.
+    std::atomic<qint64> m_lastInput;
+};
+
+#endif //RSIBREAK_RSIIDLETIMEEVDEV_H
@@ -0,0 +1,195 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimewayland.h"
+
+#include <QDebug>
+
+#include <wayland-client.h>
+#include "wayland-ext-idle-notify-v1-client-protocol.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace
+{
+
+// Idle from this long on, as RSITimer counts in whole seconds.
+const quint32 IDLE_TIMEOUT_MS = 1000;
+
+}
+
+RSIIdleTimeWayland::RSIIdleTimeWayland()
+    : m_display( nullptr )
+    , m_registry( nullptr )
+    , m_seat( nullptr )
+    , m_seatName( 0 )
+    , m_notifier( nullptr )
+    , m_notification( nullptr )
+    , m_wakePipe{ -1, -1 }
+    , m_idleSince( -1 )
+{
+}
+
+RSIIdleTimeWayland::~RSIIdleTimeWayland()
+{
+    if ( m_thread.joinable() ) {
+        const char stop = 0;
+        if ( write( m_wakePipe[1], &stop, 1 ) < 0 )
+            qWarning() << "Could not stop the idle notification thread";
+        m_thread.join();
+    }
+    if ( m_wakePipe[0] >= 0 ) {
+        close( m_wakePipe[0] );
+        close( m_wakePipe[1] );
+    }
+    if ( m_notification )
+        ext_idle_notification_v1_destroy( m_notification );
+    if ( m_notifier )
+        ext_idle_notifier_v1_destroy( m_notifier );
+    if ( m_seat )
+        wl_seat_destroy( m_seat );
+    if ( m_registry )
+        wl_registry_destroy( m_registry );
+    if ( m_display )
+        wl_display_disconnect( m_display );
+}
+
+bool RSIIdleTimeWayland::start()
+{
+    static const wl_registry_listener registryListener = { &global, &globalRemove };
+    static const ext_idle_notification_v1_listener notificationListener = { &idled, &resumed };
+
+    m_display = wl_display_connect( nullptr );
+    if ( !m_display )
+        return false;
+
+    m_registry = wl_display_get_registry( m_display );
+    wl_registry_add_listener( m_registry, &registryListener, this );
+    if ( wl_display_roundtrip( m_display ) < 0 )
+        return false;
+    if ( !m_seat || !m_notifier ) {
+        qDebug() << "No ext-idle-notify-v1, idle time is polled";
+        return false;
+    }
+
+    // Input idle time ignores idle inhibitors, a video playing does not
+    // rest the hands.
+#ifdef EXT_IDLE_NOTIFIER_V1_GET_INPUT_IDLE_NOTIFICATION_SINCE_VERSION
+    if ( ext_idle_notifier_v1_get_version( m_notifier ) >= EXT_IDLE_NOTIFIER_V1_GET_INPUT_IDLE_NOTIFICATION_SINCE_VERSION )
+        m_notification = ext_idle_notifier_v1_get_input_idle_notification( m_notifier, IDLE_TIMEOUT_MS, m_seat );
+    else
+#endif
+        m_notification = ext_idle_notifier_v1_get_idle_notification( m_notifier, IDLE_TIMEOUT_MS, m_seat );
+    ext_idle_notification_v1_add_listener( m_notification, &notificationListener, this );
+    wl_display_flush( m_display );
+
+    if ( pipe( m_wakePipe ) < 0 ) {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+        return false;
+    }
+    fcntl( m_wakePipe[0], F_SETFD, FD_CLOEXEC );
+    fcntl( m_wakePipe[1], F_SETFD, FD_CLOEXEC );
+
+    m_thread = std::thread( &RSIIdleTimeWayland::run, this );
+    return true;
+}
+
+int RSIIdleTimeWayland::getIdleTime() const
+{
+    const qint64 since = m_idleSince.load( std::memory_order_relaxed );
+    return since < 0 ? 0 : int( now() - since );
+}
+
+void RSIIdleTimeWayland::global( void* data, wl_registry* registry, quint32 name,
+                                 const char* interface, quint32 version )
+{
+    RSIIdleTimeWayland* self = static_cast<RSIIdleTimeWayland*>( data );
+    if ( strcmp( interface, wl_seat_interface.name ) == 0 && !self->m_seat ) {
+        self->m_seat = static_cast<wl_seat*>( wl_registry_bind( registry, name, &wl_seat_interface, 1 ) );
+        self->m_seatName = name;
+    } else if ( strcmp( interface, ext_idle_notifier_v1_interface.name ) == 0 ) {
+        const quint32 bind = std::min<quint32>( version, ext_idle_notifier_v1_interface.version );
+        self->m_notifier = static_cast<ext_idle_notifier_v1*>(
+                               wl_registry_bind( registry, name, &ext_idle_notifier_v1_interface, bind ) );
+    }
+}
+
+void RSIIdleTimeWayland::globalRemove( void* data, wl_registry*, quint32 name )
+{
+    // A seat going away leaves the notification without events, the user
+    // counts as active then.
+    RSIIdleTimeWayland* self = static_cast<RSIIdleTimeWayland*>( data );
+    if ( self->m_seat && name == self->m_seatName ) {
+        qWarning() << "The seat went away, idle time is no longer known";
+        self->m_idleSince.store( -1, std::memory_order_relaxed );
+    }
+}
+
+void RSIIdleTimeWayland::idled( void* data, ext_idle_notification_v1* )
+{
+    RSIIdleTimeWayland* self = static_cast<RSIIdleTimeWayland*>( data );
+    self->m_idleSince.store( now() - IDLE_TIMEOUT_MS, std::memory_order_relaxed );
+}
+
+void RSIIdleTimeWayland::resumed( void* data, ext_idle_notification_v1* )
+{
+    RSIIdleTimeWayland* self = static_cast<RSIIdleTimeWayland*>( data );
+    self->m_idleSince.store( -1, std::memory_order_relaxed );
+}
+
+void RSIIdleTimeWayland::run()
+{
+    pollfd fds[2];
+    fds[0].fd = wl_display_get_fd( m_display );
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakePipe[0];
+    fds[1].events = POLLIN;
+
+    for ( ;; ) {
+        while ( wl_display_prepare_read( m_display ) != 0 )
+            wl_display_dispatch_pending( m_display );
+        wl_display_flush( m_display );
+
+        if ( poll( fds, 2, -1 ) < 0 ) {
+            // The revents are those of the last round then, start over.
+            wl_display_cancel_read( m_display );
+            if ( errno == EINTR )
+                continue;
+            break;
+        }
+        if ( fds[1].revents ) {
+            wl_display_cancel_read( m_display );
+            break;
+        }
+        if ( fds[0].revents & ( POLLERR | POLLHUP ) ) {
+            wl_display_cancel_read( m_display );
+            qWarning() << "Lost the connection for idle notifications";
+            m_idleSince.store( -1, std::memory_order_relaxed );
+            break;
+        }
+
+        if ( fds[0].revents & POLLIN )
+            wl_display_read_events( m_display );
+        else
+            wl_display_cancel_read( m_display );
+        wl_display_dispatch_pending( m_display );
+    }
+}
@@ -0,0 +1,75 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIIDLETIMEWAYLAND_H
+#define RSIBREAK_RSIIDLETIMEWAYLAND_H
+
+#include "rsiidletime.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+
+struct wl_display;
+struct wl_registry;
+struct wl_seat;
+struct ext_idle_notifier_v1;
+struct ext_idle_notification_v1;
+
+// Idle time from the ext-idle-notify-v1 protocol of the compositor. It
+// sends an event when the user has been idle for a second and one when
+// input comes in again. The time idle is counted locally from the first,
+// so getIdleTime() never talks to the compositor. The events are read on
+// a thread of their own with a connection of its own.
+class RSIIdleTimeWayland : public RSIIdleTime
+{
+public:
+    RSIIdleTimeWayland();
+    ~RSIIdleTimeWayland() override;
+
+    // Connects to the compositor, asks for the notification and starts the
+    // thread which receives it.
+    // @returns false when there is no compositor or it lacks the protocol.
+    bool start();
+
+    int getIdleTime() const override;
+
+private:
+    void run();
+
+    static void global( void* data, wl_registry* registry, quint32 name,
+                        const char* interface, quint32 version );
+    static void globalRemove( void* data, wl_registry* registry, quint32 name );
+    static void idled( void* data, ext_idle_notification_v1* notification );
+    static void resumed( void* data, ext_idle_notification_v1* notification );
+
+    wl_display* m_display;
+    wl_registry* m_registry;
+    wl_seat* m_seat;
+    // Registry name of m_seat, to notice its removal.
+    quint32 m_seatName;
+    ext_idle_notifier_v1* m_notifier;
+    ext_idle_notification_v1* m_notification;
+    // Written to wake up and stop the thread.
+    int m_wakePipe[2];
+    std::thread m_thread;
+
+    // Monotonic time in ms since when the user is idle, -1 while active.
+    std::atomic<qint64> m_idleSince;
+};
+
+#endif //RSIBREAK_RSIIDLETIMEWAYLAND_H
@@ -0,0 +1,187 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimexsync.h"
+
+#include <QDebug>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/sync.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace
+{
+
+// Idle from this long on, as RSITimer counts in whole seconds.
+const qint64 IDLE_ALARM_MS = 1000;
+
+qint64 toInt64( const XSyncValue& value )
+{
+    return ( qint64( XSyncValueHigh32( value ) ) << 32 ) | XSyncValueLow32( value );
+}
+
+}
+
+RSIIdleTimeXSync::RSIIdleTimeXSync()
+    : m_display( nullptr )
+    , m_eventBase( 0 )
+    , m_idleCounter( None )
+    , m_idleAlarm( None )
+    , m_activeAlarm( None )
+    , m_firstRequest( 0 )
+    , m_wakePipe{ -1, -1 }
+    , m_idleSince( -1 )
+    , m_requests( 0 )
+{
+}
+
+RSIIdleTimeXSync::~RSIIdleTimeXSync()
+{
+    if ( m_thread.joinable() ) {
+        const char stop = 0;
+        if ( write( m_wakePipe[1], &stop, 1 ) < 0 )
+            qWarning() << "Could not stop the XSync thread";
+        m_thread.join();
+    }
+    if ( m_wakePipe[0] >= 0 ) {
+        close( m_wakePipe[0] );
+        close( m_wakePipe[1] );
+    }
+    // Closing the connection frees the alarms as well.
+    if ( m_display )
+        XCloseDisplay( m_display );
+}
+
+bool RSIIdleTimeXSync::start()
+{
+    m_display = XOpenDisplay( nullptr );
+    if ( !m_display )
+        return false;
+    m_firstRequest = XNextRequest( m_display );
+
+    int error, major, minor;
+    if ( !XSyncQueryExtension( m_display, &m_eventBase, &error ) ||
+            !XSyncInitialize( m_display, &major, &minor ) ) {
+        qDebug() << "No SYNC extension, idle time is polled";
+        return false;
+    }
+
+    int count = 0;
+    XSyncSystemCounter* counters = XSyncListSystemCounters( m_display, &count );
+    for ( int i = 0; i < count; ++i ) {
+        if ( strcmp( counters[i].name, "IDLETIME" ) == 0 )
+            m_idleCounter = counters[i].counter;
+    }
+    if ( counters )
+        XSyncFreeSystemCounterList( counters );
+    if ( m_idleCounter == None ) {
+        qDebug() << "No IDLETIME counter, idle time is polled";
+        return false;
+    }
+
+    if ( pipe( m_wakePipe ) < 0 ) {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+        return false;
+    }
+    fcntl( m_wakePipe[0], F_SETFD, FD_CLOEXEC );
+    fcntl( m_wakePipe[1], F_SETFD, FD_CLOEXEC );
+
+    // Fires right away when the user is idle already.
+    setAlarm( m_idleAlarm, XSyncPositiveComparison, IDLE_ALARM_MS );
+    XFlush( m_display );
+    m_requests = XNextRequest( m_display ) - m_firstRequest;
+
+    m_thread = std::thread( &RSIIdleTimeXSync::run, this );
+    return true;
+}
+
+int RSIIdleTimeXSync::getIdleTime() const
+{
+    const qint64 since = m_idleSince.load( std::memory_order_relaxed );
+    return since < 0 ? 0 : int( now() - since );
+}
+
+void RSIIdleTimeXSync::setAlarm( unsigned long& alarm, int testType, qint64 value )
+{
+    // Without a delta the alarm goes inactive once it fired, until it
+    // is changed again.
+    XSyncAlarmAttributes attributes;
+    attributes.trigger.counter = m_idleCounter;
+    attributes.trigger.value_type = XSyncAbsolute;
+    attributes.trigger.test_type = static_cast<XSyncTestType>( testType );
+    XSyncIntsToValue( &attributes.trigger.wait_value,
+                      static_cast<unsigned int>( value & 0xffffffff ), static_cast<int>( value >> 32 ) );
+    XSyncIntToValue( &attributes.delta, 0 );
+    attributes.events = True;
+
+    const unsigned long flags = XSyncCACounter | XSyncCAValueType | XSyncCATestType |
+                                XSyncCAValue | XSyncCADelta | XSyncCAEvents;
+    if ( alarm == None )
+        alarm = XSyncCreateAlarm( m_display, flags, &attributes );
+    else
+        XSyncChangeAlarm( m_display, alarm, flags, &attributes );
+}
+
+void RSIIdleTimeXSync::run()
+{
+    pollfd fds[2];
+    fds[0].fd = ConnectionNumber( m_display );
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakePipe[0];
+    fds[1].events = POLLIN;
+
+    for ( ;; ) {
+        while ( XPending( m_display ) ) {
+            XEvent ev;
+            XNextEvent( m_display, &ev );
+            if ( ev.type != m_eventBase + XSyncAlarmNotify )
+                continue;
+
+            const XSyncAlarmNotifyEvent* alarm = reinterpret_cast<XSyncAlarmNotifyEvent*>( &ev );
+            if ( alarm->state == XSyncAlarmDestroyed )
+                continue;
+
+            if ( alarm->alarm == m_idleAlarm ) {
+                // The counter may be well past the threshold, e.g. when
+                // the alarm was set while the user was away.
+                const qint64 idle = toInt64( alarm->counter_value );
+                m_idleSince.store( now() - idle, std::memory_order_relaxed );
+                // Any input resets the counter below its current value.
+                setAlarm( m_activeAlarm, XSyncNegativeComparison, idle - 1 );
+            } else if ( alarm->alarm == m_activeAlarm ) {
+                m_idleSince.store( -1, std::memory_order_relaxed );
+                setAlarm( m_idleAlarm, XSyncPositiveComparison, IDLE_ALARM_MS );
+            }
+        }
+        XFlush( m_display );
+        m_requests = XNextRequest( m_display ) - m_firstRequest;
+
+        if ( poll( fds, 2, -1 ) < 0 && errno != EINTR )
+            break;
+        if ( fds[1].revents )
+            break;
+        if ( fds[0].revents & ( POLLERR | POLLHUP ) ) {
+            qWarning() << "Lost the connection for idle alarms";
+            m_idleSince.store( -1, std::memory_order_relaxed );
+            break;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIIDLETIMEXSYNC_H
+#define RSIBREAK_RSIIDLETIMEXSYNC_H
+
+#include "rsiidletime.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+
+typedef struct _XDisplay Display;
+
+// Idle time from alarms on the IDLETIME counter of the X SYNC extension.
+// The server tells when the user has been idle for a second and when
+// input comes in again, nothing is asked while the idle state stays the
+// same. The time idle is counted locally from the moment the user went
+// idle, so getIdleTime() never talks to the X server.
+class RSIIdleTimeXSync : public RSIIdleTime
+{
+public:
+    RSIIdleTimeXSync();
+    ~RSIIdleTimeXSync() override;
+
+    // Connects to the X server, sets the first alarm and starts the thread
+    // which receives the alarms.
+    // @returns false when there is no display or no IDLETIME counter.
+    bool start();
+
+    int getIdleTime() const override;
+
+    // @returns the requests sent to the X server so far.
+    quint64 requestCount() const { return m_requests; }
+
+private:
+    void run();
+    void setAlarm( unsigned long& alarm, int testType, qint64 value );
+
+    Display* m_display;
+    int m_eventBase;
+    // The IDLETIME counter and both alarms on it, XIDs.
+    unsigned long m_idleCounter;
+    unsigned long m_idleAlarm;
+    unsigned long m_activeAlarm;
+    unsigned long m_firstRequest;
+    // Written to wake up and stop the thread.
+    int m_wakePipe[2];
+    std::thread m_thread;
+
+    // Monotonic time in ms since when the user is idle, -1 while active.
+    std::atomic<qint64> m_idleSince;
+    std::atomic<quint64> m_requests;
+};
+
+#endif //RSIBREAK_RSIIDLETIMEXSYNC_H
@@ -0,0 +1,65 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiinputactivity.h"
+
+#ifdef HAVE_XINPUT2
+#include "rsiinputactivityxi2.h"
+#endif
+
+#include <QGuiApplication>
+
+RSIInputActivity::RSIInputActivity()
+    : m_keys( 0 )
+    , m_clicks( 0 )
+    , m_travel( 0 )
+    , m_ringKeys()
+    , m_ringClicks()
+    , m_position( 0 )
+    , m_minuteKeys( 0 )
+    , m_minuteClicks( 0 )
+{
+}
+
+std::unique_ptr<RSIInputActivity> RSIInputActivity::create()
+{
+#ifdef HAVE_XINPUT2
+    if ( QGuiApplication::platformName() == QLatin1String( "xcb" ) ) {
+        std::unique_ptr<RSIInputActivityXI2> xi2 { new RSIInputActivityXI2() };
+        if ( xi2->start() )
+            return xi2;
+    }
+#endif
+    return nullptr;
+}
+
+RSIInputActivity::Sample RSIInputActivity::take()
+{
+    Sample sample;
+    sample.keys = m_keys.exchange( 0, std::memory_order_relaxed );
+    sample.clicks = m_clicks.exchange( 0, std::memory_order_relaxed );
+    sample.travel = m_travel.exchange( 0, std::memory_order_relaxed );
+
+    // The sample of a minute ago leaves the ring as this one enters.
+    m_minuteKeys += int( sample.keys ) - int( m_ringKeys[m_position] );
+    m_minuteClicks += int( sample.clicks ) - int( m_ringClicks[m_position] );
+    m_ringKeys[m_position] = sample.keys;
+    m_ringClicks[m_position] = sample.clicks;
+    if ( ++m_position == MINUTE )
+        m_position = 0;
+
+    return sample;
+}
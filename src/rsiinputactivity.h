@@ -0,0 +1,81 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIINPUTACTIVITY_H
+#define RSIBREAK_RSIINPUTACTIVITY_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+
+// Counts keystrokes, clicks and mouse travel as they happen. A backend
+// thread adds to the counters, the timer takes the totals once a second.
+// Neither side allocates or locks: each counter is a single atomic, and
+// the totals of the last minute are kept in a fixed ring.
+class RSIInputActivity
+{
+public:
+    // Input counted during one second.
+    struct Sample {
+        quint32 keys;
+        quint32 clicks;
+        quint32 travel;     // pointer travel in pixels, before acceleration.
+    };
+
+    // Keystrokes and clicks per minute from which input counts as intense.
+    static const int INTENSE_PER_MINUTE = 300;
+
+    RSIInputActivity();
+    virtual ~RSIInputActivity() = default;
+
+    // @returns the backend for this session, started, or null when input
+    // cannot be observed directly.
+    static std::unique_ptr<RSIInputActivity> create();
+
+    // Called from the backend thread.
+    void addKeys( quint32 count ) { m_keys.fetch_add( count, std::memory_order_relaxed ); }
+    void addClicks( quint32 count ) { m_clicks.fetch_add( count, std::memory_order_relaxed ); }
+    void addTravel( quint32 pixels ) { m_travel.fetch_add( pixels, std::memory_order_relaxed ); }
+
+    // Takes the input counted since the last call, once a second.
+    Sample take();
+
+    // @returns keystrokes during the last 60 samples taken.
+    int keysPerMinute() const { return m_minuteKeys; }
+
+    // @returns clicks during the last 60 samples taken.
+    int clicksPerMinute() const { return m_minuteClicks; }
+
+    // @returns whether the last minute of input was intense.
+    bool isIntense() const { return m_minuteKeys + m_minuteClicks >= INTENSE_PER_MINUTE; }
+
+private:
+    static const int MINUTE = 60;
+
+    std::atomic<quint32> m_keys;
+    std::atomic<quint32> m_clicks;
+    std::atomic<quint32> m_travel;
+
+    // Only touched by take().
+    quint32 m_ringKeys[MINUTE];
+    quint32 m_ringClicks[MINUTE];
+    int m_position;
+    int m_minuteKeys;
+    int m_minuteClicks;
+};
+
+#endif //RSIBREAK_RSIINPUTACTIVITY_H
@@ -0,0 +1,206 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiinputactivityxi2.h"
+
+#include <QDebug>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <iterator>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+RSIInputActivityXI2::RSIInputActivityXI2()
+    : m_display( nullptr )
+    , m_opcode( 0 )
+    , m_wakePipe{ -1, -1 }
+{
+    std::fill( std::begin( m_relativeAxes ), std::end( m_relativeAxes ), 0 );
+}
+
+RSIInputActivityXI2::~RSIInputActivityXI2()
+{
+    if ( m_thread.joinable() ) {
+        const char stop = 0;
+        if ( write( m_wakePipe[1], &stop, 1 ) < 0 )
+            qWarning() << "Could not stop the XInput2 thread";
+        m_thread.join();
+    }
+    if ( m_wakePipe[0] >= 0 ) {
+        close( m_wakePipe[0] );
+        close( m_wakePipe[1] );
+    }
+    if ( m_display )
+        XCloseDisplay( m_display );
+}
+
+bool RSIInputActivityXI2::start()
+{
+    m_display = XOpenDisplay( nullptr );
+    if ( !m_display )
+        return false;
+
+    int event, error;
+    if ( !XQueryExtension( m_display, "XInputExtension", &m_opcode, &event, &error ) ) {
+        qDebug() << "No XInput extension, input statistics are not available";
+        return false;
+    }
+
+    // Before 2.1 raw events only reach the client holding a grab.
+    int major = 2, minor = 1;
+    if ( XIQueryVersion( m_display, &major, &minor ) != Success || ( major == 2 && minor < 1 ) ) {
+        qDebug() << "XInput" << major << minor << "is too old, input statistics are not available";
+        return false;
+    }
+
+    unsigned char mask[XIMaskLen( XI_LASTEVENT )] = { 0 };
+    XISetMask( mask, XI_RawKeyPress );
+    XISetMask( mask, XI_RawButtonPress );
+    XISetMask( mask, XI_RawMotion );
+
+    // Changes of the devices are only sent for all devices.
+    unsigned char deviceMask[XIMaskLen( XI_LASTEVENT )] = { 0 };
+    XISetMask( deviceMask, XI_HierarchyChanged );
+    XISetMask( deviceMask, XI_DeviceChanged );
+
+    // Master devices only, so input is not counted once more for each slave.
+    XIEventMask eventMasks[2];
+    eventMasks[0].deviceid = XIAllMasterDevices;
+    eventMasks[0].mask_len = sizeof( mask );
+    eventMasks[0].mask = mask;
+    eventMasks[1].deviceid = XIAllDevices;
+    eventMasks[1].mask_len = sizeof( deviceMask );
+    eventMasks[1].mask = deviceMask;
+    XISelectEvents( m_display, DefaultRootWindow( m_display ), eventMasks, 2 );
+    updateDevices();
+    XFlush( m_display );
+
+    if ( pipe( m_wakePipe ) < 0 ) {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+        return false;
+    }
+    fcntl( m_wakePipe[0], F_SETFD, FD_CLOEXEC );
+    fcntl( m_wakePipe[1], F_SETFD, FD_CLOEXEC );
+
+    m_thread = std::thread( &RSIInputActivityXI2::run, this );
+    return true;
+}
+
+void RSIInputActivityXI2::updateDevices()
+{
+    std::fill( std::begin( m_relativeAxes ), std::end( m_relativeAxes ), 0 );
+
+    int count = 0;
+    XIDeviceInfo* devices = XIQueryDevice( m_display, XIAllDevices, &count );
+    for ( int i = 0; i < count; ++i ) {
+        const XIDeviceInfo& device = devices[i];
+        if ( device.deviceid < 0 || device.deviceid > 255 )
+            continue;
+        for ( int c = 0; c < device.num_classes; ++c ) {
+            if ( device.classes[c]->type != XIValuatorClass )
+                continue;
+            const XIValuatorClassInfo* valuator = reinterpret_cast<const XIValuatorClassInfo*>( device.classes[c] );
+            if ( valuator->number < 2 && valuator->mode == XIModeRelative )
+                m_relativeAxes[device.deviceid] |= 1 << valuator->number;
+        }
+    }
+    XIFreeDeviceInfo( devices );
+}
+
+void RSIInputActivityXI2::run()
+{
+    pollfd fds[2];
+    fds[0].fd = ConnectionNumber( m_display );
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakePipe[0];
+    fds[1].events = POLLIN;
+
+    // Fractions of a pixel are carried over to the next motion.
+    double travel = 0.0;
+
+    for ( ;; ) {
+        // Counted per batch of events, not per event.
+        quint32 keys = 0, clicks = 0;
+
+        while ( XPending( m_display ) ) {
+            XEvent ev;
+            XNextEvent( m_display, &ev );
+            XGenericEventCookie* cookie = &ev.xcookie;
+            if ( cookie->type != GenericEvent || cookie->extension != m_opcode ||
+                    !XGetEventData( m_display, cookie ) )
+                continue;
+
+            const XIRawEvent* raw = static_cast<const XIRawEvent*>( cookie->data );
+            switch ( cookie->evtype ) {
+            case XI_HierarchyChanged:
+            case XI_DeviceChanged:
+                updateDevices();
+                break;
+            case XI_RawKeyPress:
+                if ( !( raw->flags & XIKeyRepeat ) )
+                    ++keys;
+                break;
+            case XI_RawButtonPress:
+                // Buttons 4 to 7 are the scroll wheels.
+                if ( raw->detail < 4 || raw->detail > 7 )
+                    ++clicks;
+                break;
+            case XI_RawMotion: {
+                // The values are packed, one for each bit set in the mask.
+                // Positions of absolute axes are no distance, they are skipped.
+                const int relative = raw->sourceid >= 0 && raw->sourceid <= 255 ? m_relativeAxes[raw->sourceid] : 0;
+                double delta[2] = { 0.0, 0.0 };
+                const double* value = raw->raw_values;
+                for ( int axis = 0; axis < 2 && axis < raw->valuators.mask_len * 8; ++axis ) {
+                    if ( !XIMaskIsSet( raw->valuators.mask, axis ) )
+                        continue;
+                    const double v = *value++;
+                    if ( relative & ( 1 << axis ) )
+                        delta[axis] = v;
+                }
+                travel += std::sqrt( delta[0] * delta[0] + delta[1] * delta[1] );
+                break;
+            }
+            }
+            XFreeEventData( m_display, cookie );
+        }
+
+        if ( keys )
+            addKeys( keys );
+        if ( clicks )
+            addClicks( clicks );
+        if ( travel >= 1.0 ) {
+            const quint32 pixels = static_cast<quint32>( travel );
+            addTravel( pixels );
+            travel -= pixels;
+        }
+
+        if ( poll( fds, 2, -1 ) < 0 && errno != EINTR )
+            break;
+        if ( fds[1].revents )
+            break;
+        if ( fds[0].revents & ( POLLERR | POLLHUP ) ) {
+            qWarning() << "Lost the connection for input statistics";
+            break;
+        }
+    }
+}
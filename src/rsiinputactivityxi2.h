@@ -0,0 +1,56 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_RSIINPUTACTIVITYXI2_H
+#define RSIBREAK_RSIINPUTACTIVITYXI2_H
+
+#include "rsiinputactivity.h"
+
+#include <thread>
+
+typedef struct _XDisplay Display;
+
+// Counts input from XInput2 raw events. Raw events reach the root window
+// of every client since XI 2.1, whichever window has the focus or a grab.
+// They are read on a thread of their own with a connection of its own, so
+// neither the GUI nor the timer thread ever waits on the X server.
+class RSIInputActivityXI2 : public RSIInputActivity
+{
+public:
+    RSIInputActivityXI2();
+    ~RSIInputActivityXI2() override;
+
+    // Connects to the X server and starts the thread.
+    // @returns false when there is no display or no XI 2.1.
+    bool start();
+
+private:
+    void run();
+
+    // Finds which devices move relatively, again when devices change.
+    void updateDevices();
+
+    Display* m_display;
+    int m_opcode;
+    // Bit 0 and 1 are set when the x and y axes of the device with that
+    // id are relative. Tablets and touch screens report positions instead.
+    quint8 m_relativeAxes[256];
+    // Written to wake up and stop the thread.
+    int m_wakePipe[2];
+    std::thread m_thread;
+};
+
+#endif //RSIBREAK_RSIINPUTACTIVITYXI2_H
@@ -19,6 +19,7 @@
 */
 
 #include "rsirelaxpopup.h"
+#include "rsiglobals.h"
 
 #include <QLabel>
 #include <QPushButton>
@@ -28,10 +29,8 @@
 #include <KColorScheme>
 #include <QVBoxLayout>
 #include <KLocalizedString>
-#include <KConfigGroup>
 #include <KIconLoader>
 #include <QHBoxLayout>
-#include <KFormat>
 
 RSIRelaxPopup::RSIRelaxPopup( QWidget *parent )
         : QObject( parent )
@@ -102,7 +101,7 @@ void RSIRelaxPopup::relax( int n, bool bigBreakNext )
 
     if ( n > 0 ) {
         QString text = i18n( "Please relax for %1",
-                             KFormat().formatSpelloutDuration( n * 1000 ) );
+                             RSIGlobals::instance()->formatSeconds( n ) );
 
         if ( bigBreakNext )
             text.append( '\n' + i18n( "Note: next break is a big break" ) );
@@ -146,8 +145,7 @@ void RSIRelaxPopup::slotReadConfig()
 
 void RSIRelaxPopup::readSettings()
 {
-    KConfigGroup config = KSharedConfig::openConfig()->group( "Popup Settings" );
-    m_useFlash = config.readEntry( "UseFlash", true );
+    m_useFlash = RSIGlobals::instance()->config()->useFlash;
 }
 
 void RSIRelaxPopup::setSkipButtonHidden( bool b )
@@ -53,7 +53,7 @@ public slots:
     void relax( int n, bool bigBreakNext );
 
     /**
-      Reread config
+      Takes the flash setting from RSIGlobals
     */
     void slotReadConfig();
 
@@ -103,6 +103,18 @@ RSIStats::RSIStats()
 
     m_statistics.insert( PAUSE_SCORE, new RSIStatItem( i18n( "Pause score" ), 100 ) );
 
+    m_statistics.insert( KEYSTROKES,
+                         new RSIStatItem( i18n( "Total number of keystrokes" ) ) );
+
+    m_statistics.insert( KEYSTROKES_PER_MINUTE,
+                         new RSIStatItem( i18n( "Keystrokes last minute" ) ) );
+
+    m_statistics.insert( MOUSE_CLICKS,
+                         new RSIStatItem( i18n( "Total number of mouse clicks" ) ) );
+
+    m_statistics.insert( MOUSE_TRAVEL,
+                         new RSIStatItem( i18n( "Total mouse travel" ) ) );
+
     // initialise labels
     for ( int i = 0; i < STAT_COUNT; ++i ) {
         QLabel *l = new QLabel( 0 );
@@ -178,9 +190,10 @@ void RSIStats::updateDependentStats( RSIStat stat )
             double c = m_statistics[ IDLENESS_CAUSED_SKIP_TINY ]->getValue().toDouble();
             double d = m_statistics[ IDLENESS_CAUSED_SKIP_BIG ]->getValue().toDouble();
 
-            RSIGlobals *glbl = RSIGlobals::instance();
-            double ratio = ( double )( glbl->intervals()[BIG_BREAK_DURATION] ) /
-                           ( double )( glbl->intervals()[TINY_BREAK_DURATION] );
+            // One snapshot, so both durations belong to the same settings.
+            const QVector<int> intervals = RSIGlobals::instance()->config()->intervals;
+            double ratio = ( double )( intervals[BIG_BREAK_DURATION] ) /
+                           ( double )( intervals[TINY_BREAK_DURATION] );
 
             double skipped = a - c + ratio * ( b - d );
             skipped = skipped < 0 ? 0 : skipped;
@@ -284,10 +297,19 @@ void RSIStats::updateLabel( RSIStat stat )
     case BIG_BREAKS_SKIPPED:
     case BIG_BREAKS_POSTPONED:
     case IDLENESS_CAUSED_SKIP_BIG:
+    case KEYSTROKES:
+    case KEYSTROKES_PER_MINUTE:
+    case MOUSE_CLICKS:
         l->setText( QString::number(
                         m_statistics[ stat ]->getValue().toInt() ) );
         break;
 
+        // pixels, shown as the distance on a 96 dpi screen
+    case MOUSE_TRAVEL:
+        l->setText( i18nc( "distance in meters", "%1 m",
+                           QString::number( m_statistics[ stat ]->getValue().toInt() * 0.0254 / 96, 'f', 1 ) ) );
+        break;
+
         // doubles
     case PAUSE_SCORE:
         v = m_statistics[ stat ]->getValue().toDouble();
@@ -415,6 +437,17 @@ QString RSIStats::getWhatsThisText( RSIStat stat ) const
         return i18n( "This is a percentage of activity during the last 6 hours. "
                      "The color indicates the level of your activity. When the color is "
                      "close to full red it is recommended you lower your work pace." );
+    case KEYSTROKES:
+        return i18n( "This is the total number of keys you pressed." );
+    case KEYSTROKES_PER_MINUTE:
+        return i18n( "This is the number of keys you pressed during the last minute." );
+    case MOUSE_CLICKS:
+        return i18n( "This is the total number of mouse button clicks, "
+                     "scrolling not included." );
+    case MOUSE_TRAVEL:
+        return i18n( "This is how far you moved the mouse, measured as the "
+                     "distance the pointer would cover without acceleration on "
+                     "a screen of 96 dots per inch." );
     default:
         ;
     }
@@ -19,6 +19,7 @@
 
 #include "rsistatwidget.h"
 #include "rsistats.h"
+#include "rsiappusage.h"
 
 #include <QGridLayout>
 #include <QGroupBox>
@@ -29,6 +30,9 @@
 #include <KLocalizedString>
 #include <QFontDatabase>
 
+// Applications listed in the statistics.
+static const int TOP_APPLICATIONS = 4;
+
 RSIStatWidget::RSIStatWidget( QWidget *parent )
         : QWidget( parent )
 {
@@ -69,6 +73,32 @@ RSIStatWidget::RSIStatWidget( QWidget *parent )
     addStat( BIG_BREAKS_POSTPONED, subgrid, 3 );
     addStat( IDLENESS_CAUSED_SKIP_BIG, subgrid, 4 );
     mGrid->addWidget( gb, 1, 1 );
+
+    gb = new QGroupBox( i18n( "Input" ), this );
+    subgrid = new QGridLayout( gb );
+    addStat( KEYSTROKES, subgrid, 0 );
+    addStat( KEYSTROKES_PER_MINUTE, subgrid, 1 );
+    addStat( MOUSE_CLICKS, subgrid, 2 );
+    addStat( MOUSE_TRAVEL, subgrid, 3 );
+    mGrid->addWidget( gb, 2, 0 );
+
+    gb = new QGroupBox( i18n( "Applications Today" ), this );
+    gb->setWhatsThis( i18n( "The applications you were active in for the longest time today." ) );
+    subgrid = new QGridLayout( gb );
+    for ( int i = 0; i < TOP_APPLICATIONS; ++i ) {
+        QLabel *name = new QLabel( gb );
+        QLabel *time = new QLabel( gb );
+        time->setAlignment( Qt::AlignRight );
+        subgrid->addWidget( name, i, 0 );
+        subgrid->addWidget( time, i, 1 );
+        mAppNames << name;
+        mAppTimes << time;
+    }
+    mGrid->addWidget( gb, 2, 1 );
+
+    // The other stats update as they change, these are only asked for.
+    mAppTimer.setInterval( 1000 );
+    connect( &mAppTimer, &QTimer::timeout, this, &RSIStatWidget::updateApplications );
 }
 
 RSIStatWidget::~RSIStatWidget() {}
@@ -116,9 +146,26 @@ void RSIStatWidget::addStat( RSIStat stat, QGridLayout *grid, int row )
 void RSIStatWidget::showEvent( QShowEvent * )
 {
     RSIGlobals::instance()->stats()->doUpdates( true );
+    updateApplications();
+    mAppTimer.start();
 }
 
 void RSIStatWidget::hideEvent( QHideEvent * )
 {
     RSIGlobals::instance()->stats()->doUpdates( false );
+    mAppTimer.stop();
+}
+
+void RSIStatWidget::updateApplications()
+{
+    const QVector<RSIAppUsage::Entry> top = RSIGlobals::instance()->appUsage()->top( TOP_APPLICATIONS );
+    for ( int i = 0; i < TOP_APPLICATIONS; ++i ) {
+        if ( i < top.size() ) {
+            mAppNames[i]->setText( top[i].first );
+            mAppTimes[i]->setText( RSIGlobals::instance()->formatSeconds( top[i].second ) );
+        } else {
+            mAppNames[i]->clear();
+            mAppTimes[i]->clear();
+        }
+    }
 }
@@ -22,7 +22,10 @@
 
 #include "rsiglobals.h"
 
+#include <QTimer>
+
 class QGridLayout;
+class QLabel;
 
 class RSIStatWidget : public QWidget
 {
@@ -36,7 +39,13 @@ protected:
     void showEvent( QShowEvent * ) override;
     void hideEvent( QHideEvent * ) override;
 private:
+    void updateApplications();
+
     QGridLayout *mGrid;
+    // Names and times of the applications used longest today.
+    QVector<QLabel *> mAppNames;
+    QVector<QLabel *> mAppTimes;
+    QTimer mAppTimer;
 };
 
 #endif
@@ -26,16 +26,35 @@
 #include <QDebug>
 #include <QTimer>
 
-#include <kconfig.h>
-#include <kconfiggroup.h>
-#include <ksharedconfig.h>
-
+#include "rsiappusage.h"
 #include "rsiglobals.h"
 #include "rsistats.h"
 
+namespace
+{
+
+bool intervalsDiffer( const QVector<int>& a, const QVector<int>& b, int first, int last )
+{
+    for ( int i = first; i <= last; ++i ) {
+        if ( a[i] != b[i] )
+            return true;
+    }
+    return false;
+}
+
+}
+
 RSITimer::RSITimer( QObject *parent ) : QThread( parent )
-    , m_idleTimeInstance( new RSIIdleTimeImpl() )
+    , m_idleTimeInstance( RSIIdleTime::create() )
+    , m_inputActivity( RSIInputActivity::create() )
+    , m_useInputIntensity( false )
     , m_intervals( RSIGlobals::instance()->intervals() )
+    , m_followConfig( true )
+    , m_configVersion( 0 )
+    , m_overBudget( false )
+    , m_inhibited( false )
+    , m_locked( false )
+    , m_lastCheck( QDateTime::currentDateTime() )
     , m_state ( TimerState::Monitoring )
 {
     updateConfig( true );
@@ -46,23 +65,54 @@ RSITimer::RSITimer( std::unique_ptr<RSIIdleTime> &&_idleTime, const QVector<int>
     , m_idleTimeInstance( std::move(_idleTime) )
     , m_usePopup( _usePopup )
     , m_useIdleTimers( _useIdleTimers )
+    , m_useInputIntensity( false )
     , m_intervals( _intervals )
+    , m_followConfig( false )
+    , m_configVersion( 0 )
+    , m_overBudget( false )
+    , m_inhibited( false )
+    , m_locked( false )
+    , m_lastCheck( QDateTime::currentDateTime() )
     , m_state( TimerState::Monitoring )
 {
     createTimers();
 }
 
 void RSITimer::createTimers()
+{
+    if ( m_schedules.count() == 0 ) {
+        // The big break wins when both are due at once.
+        m_tinyBreak = m_schedules.add( RSIBreakSchedules::ShortBreak, 0, 0, 0, 0 );
+        m_bigBreak = m_schedules.add( RSIBreakSchedules::LongBreak, 1, 0, 0, 0 );
+        m_activeBreak = m_tinyBreak;
+    }
+    createBigCounter();
+    createTinyCounter();
+    createActivityWindow();
+}
+
+void RSITimer::createBigCounter()
 {
     int bigThreshold = m_useIdleTimers ? m_intervals[BIG_BREAK_THRESHOLD] : INT_MAX;
+    m_schedules.set( m_bigBreak, m_intervals[BIG_BREAK_INTERVAL], m_intervals[BIG_BREAK_DURATION], bigThreshold );
+}
+
+void RSITimer::createTinyCounter()
+{
     int tinyThreshold = m_useIdleTimers ? m_intervals[TINY_BREAK_THRESHOLD] : INT_MAX;
+    m_schedules.set( m_tinyBreak, m_intervals[TINY_BREAK_INTERVAL], m_intervals[TINY_BREAK_DURATION], tinyThreshold );
+}
 
-    m_bigBreakCounter = std::unique_ptr<RSITimerCounter> {
-        new RSITimerCounter( m_intervals[BIG_BREAK_INTERVAL], m_intervals[BIG_BREAK_DURATION], bigThreshold )
-    };
-    m_tinyBreakCounter = std::unique_ptr<RSITimerCounter> {
-        new RSITimerCounter( m_intervals[TINY_BREAK_INTERVAL], m_intervals[TINY_BREAK_DURATION], tinyThreshold )
-    };
+void RSITimer::createActivityWindow()
+{
+    m_overBudget = false;
+    if ( m_intervals[ACTIVITY_BUDGET] > 0 ) {
+        m_activityWindow = std::unique_ptr<RSIActivityWindow> {
+            new RSIActivityWindow( m_intervals[ACTIVITY_WINDOW], m_intervals[ACTIVITY_BUDGET] )
+        };
+    } else {
+        m_activityWindow = nullptr;
+    }
 }
 
 void RSITimer::run()
@@ -77,37 +127,51 @@ void RSITimer::run()
 void RSITimer::hibernationDetector( const int totalIdle )
 {
     // poor mans hibernation detector....
-    static QDateTime last = QDateTime::currentDateTime();
     QDateTime current = QDateTime::currentDateTime();
-    if ( last.secsTo( current ) > 60 ) {
+    if ( m_lastCheck.secsTo( current ) > 60 ) {
         qDebug() << "Not been checking idleTime for more than 60 seconds, "
                  << "assuming the computer hibernated, resetting timers"
-                 << "Last: " << last
+                 << "Last: " << m_lastCheck
                  << "Current: " << current
                  << "Idle, s: " << totalIdle;
         resetAfterBreak();
     }
-    last = current;
+    m_lastCheck = current;
 }
 
 int RSITimer::idleTime()
 {
     int totalIdle = m_idleTimeInstance->getIdleTime() / 1000;
     hibernationDetector( totalIdle );
-
-    // TODO Find a modern-desktop way to check if the screensaver is inhibited
-    // and disable the timer because we assume you're doing for example a presentation and
-    // don't want rsibreak to annoy you
-
     return totalIdle;
 }
 
-void RSITimer::doBreakNow( const int breakTime, const bool nextBreakIsBig )
+int RSITimer::takeInputActivity( const int idleSeconds )
+{
+    if ( !m_inputActivity )
+        return 1;
+
+    const RSIInputActivity::Sample input = m_inputActivity->take();
+    RSIStats* stats = RSIGlobals::instance()->stats();
+    if ( input.keys )
+        stats->increaseStat( KEYSTROKES, input.keys );
+    if ( input.clicks )
+        stats->increaseStat( MOUSE_CLICKS, input.clicks );
+    if ( input.travel )
+        stats->increaseStat( MOUSE_TRAVEL, input.travel );
+    if ( stats->getStat( KEYSTROKES_PER_MINUTE ).toInt() != m_inputActivity->keysPerMinute() )
+        stats->setStat( KEYSTROKES_PER_MINUTE, m_inputActivity->keysPerMinute() );
+
+    // An active second of intense typing counts double.
+    return ( m_useInputIntensity && idleSeconds == 0 && m_inputActivity->isIntense() ) ? 2 : 1;
+}
+
+void RSITimer::doBreakNow( const int breakTime )
 {
     m_state = TimerState::Resting;
     m_pauseCounter = std::unique_ptr<RSITimerCounter> { new RSITimerCounter( breakTime, breakTime, INT_MAX ) };
     m_popupCounter = nullptr;
-    if ( nextBreakIsBig ) {
+    if ( m_schedules.kind( m_activeBreak ) == RSIBreakSchedules::LongBreak ) {
         emit startLongBreak();
     } else {
         emit startShortBreak();
@@ -125,11 +189,14 @@ void RSITimer::resetAfterBreak()
     emit updateIdleAvg( 0.0 );
     emit relax( -1, false );
     emit minimize();
-    if ( m_bigBreakCounter->isReset() ) {
+    if ( m_schedules.kind( m_activeBreak ) == RSIBreakSchedules::LongBreak ) {
+        // A long break taken also answers a used up budget.
+        m_overBudget = false;
         emit endLongBreak();
     } else {
         emit endShortBreak();
     }
+    m_activeBreak = m_tinyBreak;
 }
 
 // -------------------------- SLOTS ------------------------//
@@ -151,6 +218,85 @@ void RSITimer::slotSuspended( bool suspend )
     suspend ? slotStop() : slotStart();
 }
 
+void RSITimer::slotInhibited( bool inhibited )
+{
+    m_inhibited = inhibited;
+}
+
+void RSITimer::slotScreenLocked( bool locked )
+{
+    if ( locked == m_locked )
+        return;
+    m_locked = locked;
+
+    const QDateTime now = QDateTime::currentDateTime();
+    if ( locked ) {
+        m_lockedSince = now;
+        return;
+    }
+
+    // Time asleep with the screen locked counts as well, the hibernation
+    // detector must not take it for a hibernation on its own.
+    m_lastCheck = now;
+    creditLockedTime( std::max<qint64>( 0, m_lockedSince.secsTo( now ) ) );
+}
+
+void RSITimer::creditLockedTime( const int seconds )
+{
+    if ( seconds <= 0 || m_state == TimerState::Suspended )
+        return;
+    qDebug() << "Screen was locked for" << seconds << "seconds";
+
+    RSIStats* stats = RSIGlobals::instance()->stats();
+    stats->increaseStat( TOTAL_TIME, seconds );
+    // Setting MAX_IDLENESS counts one more second of IDLENESS.
+    stats->increaseStat( IDLENESS, seconds - 1 );
+    stats->setStat( MAX_IDLENESS, seconds, true );
+
+    if ( m_activityWindow ) {
+        for ( int i = 0; i < std::min( seconds, m_activityWindow->window() ); ++i )
+            m_activityWindow->tick( false );
+    }
+
+    switch ( m_state ) {
+    case TimerState::Monitoring:
+        countIdleResets( m_schedules.credit( seconds ) );
+        emit updateIdleAvg( 100.0 - ( ( tinyLeft() / ( double ) m_intervals[TINY_BREAK_INTERVAL] ) * 100.0 ) );
+        break;
+    case TimerState::Suggesting:
+    case TimerState::Resting:
+        // The break went on behind the lock screen.
+        if ( seconds >= m_pauseCounter->counterLeft() ) {
+            resetAfterBreak();
+        } else {
+            for ( int i = 0; i < seconds; ++i )
+                m_pauseCounter->tick( 0 );
+            emit updateWidget( m_pauseCounter->counterLeft() );
+        }
+        break;
+    default:
+        break;
+    }
+    defaultUpdateToolTip();
+}
+
+void RSITimer::countIdleResets( quint32 idleReset )
+{
+    for ( int i = 0; idleReset != 0; ++i, idleReset >>= 1 ) {
+        if ( !( idleReset & 1 ) )
+            continue;
+        if ( m_schedules.kind( i ) == RSIBreakSchedules::LongBreak ) {
+            // Idle for as long as a long break, that answers the budget as well.
+            m_overBudget = false;
+            RSIGlobals::instance()->stats()->increaseStat( BIG_BREAKS );
+            RSIGlobals::instance()->stats()->increaseStat( IDLENESS_CAUSED_SKIP_BIG );
+        } else {
+            RSIGlobals::instance()->stats()->increaseStat( TINY_BREAKS );
+            RSIGlobals::instance()->stats()->increaseStat( IDLENESS_CAUSED_SKIP_TINY );
+        }
+    }
+}
+
 void RSITimer::slotLock()
 {
     resetAfterBreak();
@@ -158,7 +304,7 @@ void RSITimer::slotLock()
 
 void RSITimer::skipBreak()
 {
-    if ( m_bigBreakCounter->isReset() ) {
+    if ( m_schedules.kind( m_activeBreak ) == RSIBreakSchedules::LongBreak ) {
         RSIGlobals::instance()->stats()->increaseStat( BIG_BREAKS_SKIPPED );
         emit bigBreakSkipped();
     } else {
@@ -170,11 +316,10 @@ void RSITimer::skipBreak()
 
 void RSITimer::postponeBreak()
 {
-    if ( m_bigBreakCounter->isReset() ) {
-        m_bigBreakCounter->postpone( m_intervals[POSTPONE_BREAK_INTERVAL] );
+    m_schedules.postpone( m_activeBreak, m_intervals[POSTPONE_BREAK_INTERVAL] );
+    if ( m_schedules.kind( m_activeBreak ) == RSIBreakSchedules::LongBreak ) {
         RSIGlobals::instance()->stats()->increaseStat( BIG_BREAKS_POSTPONED );
     } else {
-        m_tinyBreakCounter->postpone( m_intervals[POSTPONE_BREAK_INTERVAL] );
         RSIGlobals::instance()->stats()->increaseStat( TINY_BREAKS_POSTPONED );
     }
     resetAfterBreak();
@@ -182,21 +327,40 @@ void RSITimer::postponeBreak()
 
 void RSITimer::updateConfig( bool doRestart )
 {
-    KConfigGroup popupConfig = KSharedConfig::openConfig()->group( "Popup Settings" );
-    m_usePopup = popupConfig.readEntry( "UsePopup", true );
+    // The version is taken before the snapshot: should another one be
+    // published in between, the next tick picks that up as well.
+    RSIGlobals* glbl = RSIGlobals::instance();
+    m_configVersion = glbl->configVersion();
+    const std::shared_ptr<const RSIConfig> config = glbl->config();
+    m_usePopup = config->usePopup;
 
     bool oldUseIdleTimers = m_useIdleTimers;
-    KConfigGroup generalConfig = KSharedConfig::openConfig()->group( "General Settings" );
-    m_useIdleTimers = !( generalConfig.readEntry( "UseNoIdleTimer", false ) );
+    m_useIdleTimers = config->useIdleTimers;
+    m_useInputIntensity = config->useInputIntensity;
     doRestart = doRestart || ( oldUseIdleTimers != m_useIdleTimers );
 
     const QVector<int> oldIntervals = m_intervals;
-    m_intervals = RSIGlobals::instance()->intervals();
-    doRestart = doRestart || ( m_intervals != oldIntervals );
+    m_intervals = config->intervals;
 
     if ( doRestart ) {
         qDebug() << "Timeout parameters have changed, counters were reset.";
         createTimers();
+        return;
+    }
+
+    // Only reset the counter whose parameters changed, a new postpone time
+    // or patience does not need any reset at all.
+    if ( intervalsDiffer( oldIntervals, m_intervals, BIG_BREAK_INTERVAL, BIG_BREAK_THRESHOLD ) ) {
+        qDebug() << "Big break parameters have changed, counter was reset.";
+        createBigCounter();
+    }
+    if ( intervalsDiffer( oldIntervals, m_intervals, TINY_BREAK_INTERVAL, TINY_BREAK_THRESHOLD ) ) {
+        qDebug() << "Tiny break parameters have changed, counter was reset.";
+        createTinyCounter();
+    }
+    if ( intervalsDiffer( oldIntervals, m_intervals, ACTIVITY_WINDOW, ACTIVITY_BUDGET ) ) {
+        qDebug() << "Activity budget has changed, window was reset.";
+        createActivityWindow();
     }
 }
 
@@ -204,44 +368,65 @@ void RSITimer::updateConfig( bool doRestart )
 
 void RSITimer::timeout()
 {
+    // Only an atomic load as long as the settings are unchanged.
+    if ( m_followConfig && RSIGlobals::instance()->configVersion() != m_configVersion ) {
+        updateConfig();
+    }
+
     // Don't change the tray icon when suspended, or evaluate a possible break.
-    if ( m_state == TimerState::Suspended ) {
+    // Nobody is at the keyboard while the screen is locked, the time is
+    // credited at once on unlock.
+    if ( m_state == TimerState::Suspended || m_locked ) {
+        // Input while suspended is neither counted nor kept for later.
+        if ( m_inputActivity )
+            m_inputActivity->take();
         return;
     }
 
     const int idleSeconds = idleTime(); // idleSeconds == 0 means activity
+    const int weight = takeInputActivity( idleSeconds );
 
     RSIGlobals::instance()->stats()->increaseStat( TOTAL_TIME );
     RSIGlobals::instance()->stats()->setStat( CURRENT_IDLE_TIME, idleSeconds );
     if ( idleSeconds == 0 ) {
         RSIGlobals::instance()->stats()->increaseStat( ACTIVITY );
+        RSIGlobals::instance()->appUsage()->tick();
     } else {
         RSIGlobals::instance()->stats()->setStat( MAX_IDLENESS, idleSeconds, true );
     }
 
+    // Counted in every state, so the idle time of a break drains the window.
+    // The budget may run out during a break too, it is latched until a long
+    // break answers it.
+    if ( m_activityWindow && m_activityWindow->tick( idleSeconds == 0 ) )
+        m_overBudget = true;
+
     switch ( m_state ) {
     case TimerState::Monitoring: {
         // This is a weird thing to track as now when user was away, they will get back to zero counters,
         // not to an arbitrary time elapsed since last "idleness-skip-break".
-        bool bigWasReset = m_bigBreakCounter->isReset();
-        bool tinyWasReset = m_tinyBreakCounter->isReset();
-
-        int breakTime = std::max( m_bigBreakCounter->tick( idleSeconds ), m_tinyBreakCounter->tick( idleSeconds ) );
-        if ( breakTime > 0 ) {
-            suggestBreak( breakTime );
+        RSIBreakSchedules::Due due = m_schedules.tick( idleSeconds, weight );
+        if ( m_overBudget && !m_inhibited ) {
+            // Too much activity in the window, whatever the gaps, calls for a long break.
+            m_overBudget = false;
+            m_schedules.reset( m_bigBreak );
+            due.schedule = m_bigBreak;
+            due.breakLength = std::max( due.breakLength, m_intervals[BIG_BREAK_DURATION] );
+        }
+        if ( due.schedule >= 0 && m_inhibited ) {
+            // Not now, but on the next tick after the inhibition. Idling
+            // through a movie still counts as the break. A used up budget
+            // stays latched meanwhile.
+            countIdleResets( m_schedules.defer( due.dueMask, idleSeconds ) );
+        } else if ( due.schedule >= 0 ) {
+            m_activeBreak = due.schedule;
+            suggestBreak( due.breakLength );
         } else {
             // Not a time for break yet, but if one of the counters got reset, that means we were idle enough to skip.
-            if ( !bigWasReset && m_bigBreakCounter->isReset() ) {
-                RSIGlobals::instance()->stats()->increaseStat( BIG_BREAKS );
-                RSIGlobals::instance()->stats()->increaseStat( IDLENESS_CAUSED_SKIP_BIG );
-            }
-            if ( !tinyWasReset && m_tinyBreakCounter->isReset() ) {
-                RSIGlobals::instance()->stats()->increaseStat( TINY_BREAKS );
-                RSIGlobals::instance()->stats()->increaseStat( IDLENESS_CAUSED_SKIP_TINY );
-            }
+            countIdleResets( due.idleReset );
         }
         const double value =
-            100.0 - ( ( m_tinyBreakCounter->counterLeft() / ( double ) m_intervals[TINY_BREAK_INTERVAL] ) * 100.0 );
+            100.0 - ( ( tinyLeft() / ( double ) m_intervals[TINY_BREAK_INTERVAL] ) * 100.0 );
         emit updateIdleAvg( value );
         break;
     }
@@ -252,7 +437,7 @@ void RSITimer::timeout()
             // User kept working throw the suggestion timeout. Well, their loss.
             emit relax( -1, false );
             breakTime = m_pauseCounter->counterLeft();
-            doBreakNow( breakTime, false );
+            doBreakNow( breakTime );
             break;
         }
 
@@ -285,7 +470,7 @@ void RSITimer::timeout()
 
 void RSITimer::suggestBreak( const int breakTime )
 {
-    if ( m_bigBreakCounter->isReset() ) {
+    if ( m_schedules.kind( m_activeBreak ) == RSIBreakSchedules::LongBreak ) {
         RSIGlobals::instance()->stats()->increaseStat( BIG_BREAKS );
         RSIGlobals::instance()->stats()->setStat( LAST_BIG_BREAK, QVariant( QDateTime::currentDateTime() ) );
     } else {
@@ -293,9 +478,10 @@ void RSITimer::suggestBreak( const int breakTime )
         RSIGlobals::instance()->stats()->setStat( LAST_TINY_BREAK, QVariant( QDateTime::currentDateTime() ) );
     }
 
-    bool nextOneIsBig = m_bigBreakCounter->counterLeft() <= m_tinyBreakCounter->getDelayTicks();
+    // Warn when the break after this one is a long one.
+    bool nextOneIsBig = m_schedules.kind( m_schedules.next() ) == RSIBreakSchedules::LongBreak;
     if ( !m_usePopup ) {
-        doBreakNow( breakTime, nextOneIsBig );
+        doBreakNow( breakTime );
         return;
     }
 
@@ -314,5 +500,5 @@ void RSITimer::suggestBreak( const int breakTime )
 
 void RSITimer::defaultUpdateToolTip()
 {
-    emit updateToolTip( m_tinyBreakCounter->counterLeft(), m_bigBreakCounter->counterLeft() );
+    emit updateToolTip( tinyLeft(), bigLeft() );
 }
@@ -22,10 +22,14 @@
 #ifndef RSITimer_H
 #define RSITimer_H
 
+#include <QDateTime>
 #include <QThread>
 #include <QVector>
 #include <memory>
 
+#include "rsiactivitywindow.h"
+#include "rsibreakschedules.h"
+#include "rsiinputactivity.h"
 #include "rsitimercounter.h"
 #include "rsiidletime.h"
 
@@ -51,14 +55,17 @@ public:
     // Check whether the timer is suspended.
     bool isSuspended() const { return m_state == TimerState::Suspended; }
 
-    int tinyLeft() const { return m_tinyBreakCounter->counterLeft(); };
+    int tinyLeft() const { return m_schedules.counterLeft( m_tinyBreak ); };
 
-    int bigLeft() const { return m_bigBreakCounter->counterLeft(); };
+    int bigLeft() const { return m_schedules.counterLeft( m_bigBreak ); };
 
 public slots:
 
     /**
-      Reads the configuration and restarts the timer with slotRestart.
+      Takes the current configuration snapshot from RSIGlobals and resets
+      the counters when @p doRestart is set or the intervals or idle
+      detection changed. Called by timeout() whenever a new snapshot has
+      been published.
     */
     void updateConfig( bool doRestart = false );
 
@@ -78,6 +85,13 @@ public slots:
      */
     void slotStart();
 
+    /**
+      Called when the screen gets locked or unlocked, from anywhere. While
+      locked the idle time is not queried, on unlock the time locked is
+      credited as a break.
+    */
+    void slotScreenLocked( bool locked );
+
     /**
       Called when user locks the screen for pause. Resets current timers if currently suggesting.
     */
@@ -97,6 +111,13 @@ public slots:
     */
     void postponeBreak();
 
+    /**
+      Called when the user starts or stops asking not to be disturbed, e.g.
+      during a presentation. Breaks falling due meanwhile are deferred
+      until it is over.
+    */
+    void slotInhibited( bool inhibited );
+
     /**
       Queries X how many seconds the user has been idle. A value of 0
       means there was activity during the last second.
@@ -170,11 +191,19 @@ signals:
 
 private:
     std::unique_ptr<RSIIdleTime> m_idleTimeInstance;
+    // Keystrokes, clicks and mouse travel, null when not available.
+    std::unique_ptr<RSIInputActivity> m_inputActivity;
 
     bool m_usePopup;
     bool m_useIdleTimers;
+    bool m_useInputIntensity;
     QVector<int> m_intervals;
 
+    // Whether to follow the snapshots of RSIGlobals, tests use fixed values.
+    bool m_followConfig;
+    // Version of the snapshot the values above were taken from.
+    quint64 m_configVersion;
+
     enum class TimerState {
         Suspended = 0,      // user has suspended either via dbus or tray.
         Monitoring,         // normal cycle, waiting for break to trigger.
@@ -182,15 +211,36 @@ private:
         Resting             // suggestion ignored, waiting out the break.
     } m_state;
 
-    std::unique_ptr<RSITimerCounter> m_bigBreakCounter;
-    std::unique_ptr<RSITimerCounter> m_tinyBreakCounter;
+    RSIBreakSchedules m_schedules;
+    int m_tinyBreak;
+    int m_bigBreak;
+    // The schedule whose break is suggested or running.
+    int m_activeBreak;
+
+    // Active time in a sliding window, null without a budget.
+    std::unique_ptr<RSIActivityWindow> m_activityWindow;
+    // The budget was used up, a long break follows when monitoring.
+    bool m_overBudget;
+    // Cached from InhibitionWatcher, breaks wait while set.
+    bool m_inhibited;
+    // The screen is locked, since when.
+    bool m_locked;
+    QDateTime m_lockedSince;
+    // Last time the idle time was checked, to detect hibernation.
+    QDateTime m_lastCheck;
     std::unique_ptr<RSITimerCounter> m_pauseCounter;
     std::unique_ptr<RSITimerCounter> m_popupCounter;
 
     void hibernationDetector( const int totalIdle );
+    int takeInputActivity( const int idleSeconds );
+    void countIdleResets( quint32 idleReset );
+    void creditLockedTime( const int seconds );
     void suggestBreak( const int time );
     void defaultUpdateToolTip();
     void createTimers();
+    void createBigCounter();
+    void createTinyCounter();
+    void createActivityWindow();
 
     // This function is called when a break has passed.
     void resetAfterBreak();
@@ -201,9 +251,8 @@ private:
     /**
       Some internal preparations for a fullscreen break window.
       @param breakTime The amount of seconds to break.
-      @param nextBreakIsBig Whether the next break will be big.
     */
-    void doBreakNow( const int breakTime, const bool nextBreakIsBig );
+    void doBreakNow( const int breakTime );
 
     // Constructor for tests.
     RSITimer( std::unique_ptr<RSIIdleTime> &&_idleTime, const QVector<int> _intervals, const bool _usePopup, const bool _useIdleTimers );
@@ -20,6 +20,7 @@
 
 #include "rsiwidget.h"
 #include "rsiwidgetadaptor.h"
+#include "blureffect.h"
 #include "grayeffect.h"
 #include "popupeffect.h"
 #include "plasmaeffect.h"
@@ -28,32 +29,41 @@
 #include "rsidock.h"
 #include "rsirelaxpopup.h"
 #include "rsiglobals.h"
+#include "rsiappusage.h"
+#include "dbusclient.h"
+#include "configwatcher.h"
+#include "inhibitionwatcher.h"
 
 #include <QDebug>
 #include <QDesktopWidget>
 #include <QPainter>
+#include <QStandardPaths>
 #include <QTimer>
 
 #include <KLocalizedString>
 #include <KMessageBox>
 #include <KIconLoader>
 #include <KNotification>
-#include <QDBusInterface>
 #include <QTemporaryFile>
-#include <KConfigGroup>
 #include <KSharedConfig>
 
 #include <time.h>
 #include <math.h>
-#include <KFormat>
+
+// Seconds before a break at which the effect starts loading its resources.
+static const int PREPARE_BREAK_SECONDS = 5;
+
+// Tray icon frame indices for suspended and for nothing set yet.
+static const int SUSPENDED_FRAME = -1;
+static const int NO_FRAME = -2;
 
 RSIObject::RSIObject( QWidget *parent ) : QObject( parent )
         , m_timer(nullptr), m_effect( 0 )
-        , m_useImages( false ), m_usePlasma( false ), m_usePlasmaRO( false )
+        , m_effectPrepared( false ), m_breakPending( false ), m_iconFrame( NO_FRAME )
 {
     // Keep these 2 lines _above_ the messagebox, so the text actually is right.
     m_tray = new RSIDock( this );
-    m_tray->setIconByName( "rsibreak0" );
+    m_tray->setIconByPixmap( m_progressIcon.frame( 0 ) );
 
     new RsiwidgetAdaptor( this );
     QDBusConnection dbus = QDBusConnection::sessionBus();
@@ -63,10 +73,20 @@ RSIObject::RSIObject( QWidget *parent ) : QObject( parent )
     connect(m_relaxpopup, &RSIRelaxPopup::lock, this, &RSIObject::slotLock);
 
     connect(m_tray, &RSIDock::configChanged, this, &RSIObject::readConfig);
-    connect(m_tray, &RSIDock::configChanged, RSIGlobals::instance(), &RSIGlobals::slotReadConfig );
-    connect(m_tray, &RSIDock::configChanged, m_relaxpopup, &RSIRelaxPopup::slotReadConfig);
     connect(m_tray, &RSIDock::suspend, m_relaxpopup, &RSIRelaxPopup::setSuspended);
 
+    m_configWatcher = new ConfigWatcher( KSharedConfig::openConfig()->name(), this );
+    connect(m_configWatcher, &ConfigWatcher::configRead, this, &RSIObject::slotConfigFileChanged);
+
+    m_inhibitionWatcher = new InhibitionWatcher( dbus, QString(), QString(), this );
+    m_inhibitionWatcher->watchFullScreen();
+
+    // Not in rsibreakrc, the config watcher would reload it on every save.
+    RSIAppUsage* appUsage = RSIGlobals::instance()->appUsage();
+    appUsage->setStorage( KSharedConfig::openConfig( QStringLiteral( "rsibreakusagerc" ), KConfig::SimpleConfig,
+                                                     QStandardPaths::AppDataLocation ) );
+    appUsage->watchActiveWindow();
+
     qsrand( time( NULL ) );
 
     readConfig();
@@ -79,12 +99,13 @@ RSIObject::RSIObject( QWidget *parent ) : QObject( parent )
 RSIObject::~RSIObject()
 {
     delete m_effect;
-    delete RSIGlobals::instance();
+    // The timer thread counts into the globals until it is stopped.
     if (m_timer != nullptr) {
         m_timer->quit();
         m_timer->wait();
         delete m_timer;
     }
+    delete RSIGlobals::instance();
 }
 
 void RSIObject::slotWelcome()
@@ -101,12 +122,49 @@ void RSIObject::slotWelcome()
 
 void RSIObject::minimize()
 {
+    // Deactivating also releases what the effect prepared.
     m_effect->deactivate();
+    m_effectPrepared = false;
+    m_breakPending = false;
+
+    if ( m_deferredConfig ) {
+        const RSIConfig config = *m_deferredConfig;
+        m_deferredConfig.reset();
+        applyConfig( config );
+    }
 }
 
 void RSIObject::maximize()
 {
+    m_breakPending = true;
     m_effect->activate();
+    m_effectPrepared = true;
+}
+
+void RSIObject::prepareBreak( int tinyLeft, int bigLeft )
+{
+    const int left = qMin( tinyLeft, bigLeft );
+    if ( left <= 0 )
+        return;
+
+    if ( !m_effectPrepared && left <= PREPARE_BREAK_SECONDS ) {
+        m_effect->prepare();
+        m_effectPrepared = true;
+    } else if ( m_effectPrepared && !m_breakPending && left > 2 * PREPARE_BREAK_SECONDS ) {
+        // The break did not happen, for example because the user went idle.
+        m_effect->release();
+        m_effectPrepared = false;
+    }
+}
+
+void RSIObject::relaxing( int secondsLeft )
+{
+    // The full screen effect follows when the popup's patience runs out.
+    m_breakPending = secondsLeft > 0;
+    if ( m_breakPending && !m_effectPrepared ) {
+        m_effect->prepare();
+        m_effectPrepared = true;
+    }
 }
 
 void RSIObject::slotLock()
@@ -114,15 +172,13 @@ void RSIObject::slotLock()
     m_effect->deactivate();
     m_timer->slotLock();
 
-    QDBusInterface lock( "org.freedesktop.ScreenSaver", "/ScreenSaver",
-                         "org.freedesktop.ScreenSaver" );
-    lock.call( "Lock" );
+    DBusClient::instance()->lockScreen();
 }
 
 void RSIObject::setCounters( int timeleft )
 {
     if ( timeleft > 0 ) {
-        m_effect->setLabel( KFormat().formatSpelloutDuration( timeleft * 1000 ) );
+        m_effect->setLabel( RSIGlobals::instance()->formatSeconds( timeleft ) );
     } else if ( m_timer->isSuspended() ) {
         m_effect->setLabel( i18n( "Suspended" ) );
     } else {
@@ -132,28 +188,32 @@ void RSIObject::setCounters( int timeleft )
 
 void RSIObject::updateIdleAvg( double idleAvg )
 {
-    if ( idleAvg == 0.0 )
-        setIcon( 0 );
-    else if ( idleAvg > 0 && idleAvg < 30 )
-        setIcon( 1 );
-    else if ( idleAvg >= 30 && idleAvg < 60 )
-        setIcon( 2 );
-    else if ( idleAvg >= 60 && idleAvg < 90 )
-        setIcon( 3 );
-    else
-        setIcon( 4 );
+    setIcon( idleAvg );
 }
 
-void RSIObject::setIcon( int level )
+void RSIObject::setIcon( double progress )
 {
-    QString newIcon = "rsibreak" +
-                      ( m_timer->isSuspended() ? QString( "x" ) : QString::number( level ) );
-
-    if ( newIcon != m_currentIcon ) {
-        m_tray->setIconByName( newIcon );
-        m_tray->setToolTipIconByName( newIcon );
-        m_currentIcon = newIcon;
-    }
+    // Most ticks do not move the wedge by a whole frame.
+    const int frame = m_timer->isSuspended() ? SUSPENDED_FRAME : ProgressIcon::frameFor( progress );
+    if ( frame == m_iconFrame )
+        return;
+    m_iconFrame = frame;
+
+    // The name of the matching installed icon, still offered on D-Bus.
+    int level = 4;
+    if ( progress == 0.0 )
+        level = 0;
+    else if ( progress < 30 )
+        level = 1;
+    else if ( progress < 60 )
+        level = 2;
+    else if ( progress < 90 )
+        level = 3;
+    m_currentIcon = "rsibreak" + ( frame == SUSPENDED_FRAME ? QString( "x" ) : QString::number( level ) );
+
+    const QIcon& icon = frame == SUSPENDED_FRAME ? m_progressIcon.suspended() : m_progressIcon.frame( frame );
+    m_tray->setIconByPixmap( icon );
+    m_tray->setToolTipIconByPixmap( icon );
 }
 
 // ------------------- Popup for skipping break ------------- //
@@ -172,18 +232,16 @@ void RSIObject::bigBreakSkipped()
 
 void RSIObject::configureTimer()
 {
-    if (m_timer != nullptr) {
-        m_timer->updateConfig();
-        return;
-    }
     m_timer = new RSITimer(this);
 
     connect(m_timer, &RSITimer::breakNow, this, &RSIObject::maximize, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateWidget, this, &RSIObject::setCounters, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateToolTip, m_tray, &RSIDock::setCounters, Qt::QueuedConnection );
+    connect(m_timer, &RSITimer::updateToolTip, this, &RSIObject::prepareBreak, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::updateIdleAvg, this, &RSIObject::updateIdleAvg, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::minimize, this, &RSIObject::minimize,  Qt::QueuedConnection );
     connect(m_timer, &RSITimer::relax, m_relaxpopup, &RSIRelaxPopup::relax, Qt::QueuedConnection );
+    connect(m_timer, &RSITimer::relax, this, &RSIObject::relaxing, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::tinyBreakSkipped, this, &RSIObject::tinyBreakSkipped, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::bigBreakSkipped, this, &RSIObject::bigBreakSkipped, Qt::QueuedConnection );
     connect(m_timer, &RSITimer::startLongBreak, &m_notificator, &Notificator::onStartLongBreak );
@@ -191,7 +249,6 @@ void RSIObject::configureTimer()
     connect(m_timer, &RSITimer::startShortBreak, &m_notificator, &Notificator::onStartShortBreak );
     connect(m_timer, &RSITimer::endShortBreak, &m_notificator, &Notificator::onEndShortBreak );
 
-    connect(m_tray, &RSIDock::configChanged, m_timer, &RSITimer::updateConfig);
     connect(m_tray, &RSIDock::dialogEntered, m_timer, &RSITimer::slotStop);
     connect(m_tray, &RSIDock::dialogLeft, m_timer, &RSITimer::slotStart);
     connect(m_tray, &RSIDock::suspend, m_timer, &RSITimer::slotSuspended);
@@ -199,44 +256,85 @@ void RSIObject::configureTimer()
     connect(m_relaxpopup, &RSIRelaxPopup::skip, m_timer, &RSITimer::skipBreak);
     connect(m_relaxpopup, &RSIRelaxPopup::postpone, m_timer, &RSITimer::postponeBreak);
 
+    connect(m_inhibitionWatcher, &InhibitionWatcher::inhibitedChanged, m_timer, &RSITimer::slotInhibited);
+    m_timer->slotInhibited( m_inhibitionWatcher->isInhibited() );
+
+    connect(DBusClient::instance(), &DBusClient::screenLockChanged, m_timer, &RSITimer::slotScreenLocked);
+    DBusClient::instance()->queryScreenLock();
+
     m_timer->start();
 }
 
 void RSIObject::readConfig()
 {
-    KConfigGroup config = KSharedConfig::openConfig()->group( "General Settings" );
-
-    m_relaxpopup->setSkipButtonHidden(
-        config.readEntry( "HideMinimizeButton", false ) );
-    m_relaxpopup->setLockButtonHidden(
-        config.readEntry( "HideLockButton", false ) );
-    m_relaxpopup->setPostponeButtonHidden(
-        config.readEntry( "HidePostponeButton", false ) );
+    // The dialog wrote rsibreakrc, which supersedes a deferred reload.
+    m_deferredConfig.reset();
+    applyConfig( RSIConfig::read( *KSharedConfig::openConfig() ) );
+}
 
-    m_usePlasma = config.readEntry( "UsePlasma", false );
-    m_usePlasmaRO = config.readEntry( "UsePlasmaReadOnly", false );
+void RSIObject::slotConfigFileChanged( const RSIConfig& config )
+{
+    // Recreating the effect would end a running break, wait for its end.
+    if ( m_breakPending ) {
+        m_deferredConfig.reset( new RSIConfig( config ) );
+        return;
+    }
+    applyConfig( config );
+}
 
-    m_useImages = config.readEntry( "ShowImages", false );
-    int slideInterval = config.readEntry( "SlideInterval", 10 );
-    bool recursive =  config.readEntry( "SearchRecursiveCheck", false );
-    bool showSmallImages = config.readEntry( "ShowSmallImagesCheck", true );
-    const bool expandImageToFullScreen = config.readEntry( "ExpandImageToFullScreen", true );
-    QString path = config.readEntry( "ImageFolder" );
+void RSIObject::applyConfig( const RSIConfig& config )
+{
+    // Only touch what differs from last time, so unrelated settings do
+    // not reset the counters or rescan images.
+    const RSIConfig::Changes changes = m_effect ? config.diff( m_config ) : RSIConfig::AllChanged;
+    m_config = config;
+    RSIGlobals::instance()->setConfig( config );
+
+    // A running timer picks the new snapshot up on its next tick.
+    if ( !m_timer )
+        configureTimer();
+
+    if ( changes & RSIConfig::RelaxPopupChanged )
+        m_relaxpopup->slotReadConfig();
+
+    if ( changes & RSIConfig::ButtonsChanged ) {
+        m_relaxpopup->setSkipButtonHidden( config.hideMinimizeButton );
+        m_relaxpopup->setLockButtonHidden( config.hideLockButton );
+        m_relaxpopup->setPostponeButtonHidden( config.hidePostponeButton );
+    }
 
-    configureTimer();
+    if ( changes & RSIConfig::EffectChanged ) {
+        createEffect();
+    } else if ( changes & RSIConfig::GrayLevelChanged ) {
+        GrayEffect* gray = qobject_cast<GrayEffect*>( m_effect );
+        if ( gray )
+            gray->setLevel( config.grayLevel );
+    }
 
-    int effect =  config.readEntry( "Effect", 0 );
+    if ( changes & ( RSIConfig::ButtonsChanged | RSIConfig::EffectChanged ) ) {
+        m_effect->showMinimize( !config.hideMinimizeButton );
+        m_effect->showLock( !config.hideLockButton );
+        m_effect->showPostpone( !config.hidePostponeButton );
+        m_effect->disableShortcut( config.disableAccel );
+    }
+}
 
-    delete m_effect;
-    switch ( effect ) {
+void RSIObject::createEffect()
+{
+    // The old effect is deleted after the new one exists, so the overlay
+    // windows they share are kept.
+    BreakBase* oldEffect = m_effect;
+    m_effectPrepared = false;
+    switch ( m_config.effect ) {
     case Plasma: {
         m_effect = new PlasmaEffect( 0 );
-        m_effect->setReadOnly( m_usePlasmaRO );
+        m_effect->setReadOnly( m_config.usePlasmaReadOnly );
         break;
     }
     case SlideShow: {
         SlideEffect* slide = new SlideEffect( 0 );
-        slide->reset( path, recursive, showSmallImages, expandImageToFullScreen, slideInterval );
+        slide->reset( m_config.imageFolder, m_config.searchRecursive, m_config.showSmallImages,
+                      m_config.expandImageToFullScreen, m_config.slideInterval );
         if ( slide->hasImages() )
             m_effect = slide;
         else {
@@ -245,6 +343,10 @@ void RSIObject::readConfig()
         }
         break;
     }
+    case Blur: {
+        m_effect = new BlurEffect( 0 );
+        break;
+    }
     case Popup: {
         PopupEffect* effect = new PopupEffect( 0 );
         m_effect = effect;
@@ -253,19 +355,16 @@ void RSIObject::readConfig()
     case SimpleGray:
     default: {
         GrayEffect* effect = new GrayEffect( 0 );
-        effect->setLevel( config.readEntry( "Graylevel", 80 ) );
+        effect->setLevel( m_config.grayLevel );
         m_effect = effect;
         break;
     }
     }
+    delete oldEffect;
+
     connect(m_effect, &BreakBase::skip, m_timer, &RSITimer::skipBreak);
     connect(m_effect, &BreakBase::lock, this, &RSIObject::slotLock);
     connect(m_effect, &BreakBase::postpone, m_timer, &RSITimer::postponeBreak);
-
-    m_effect->showMinimize( !config.readEntry( "HideMinimizeButton", false ) );
-    m_effect->showLock( !config.readEntry( "HideLockButton", false ) );
-    m_effect->showPostpone( !config.readEntry( "HidePostponeButton", false ) );
-    m_effect->disableShortcut( config.readEntry( "DisableAccel", false ) );
 }
 
 void RSIObject::resume() {
@@ -275,3 +374,17 @@ void RSIObject::resume() {
 void RSIObject::suspend() {
     m_tray->doSuspend();
 }
+
+QStringList RSIObject::topApplications( int count )
+{
+    QStringList applications;
+    const QVector<RSIAppUsage::Entry> top = RSIGlobals::instance()->appUsage()->top( count );
+    for ( const RSIAppUsage::Entry& entry : top )
+        applications << entry.first;
+    return applications;
+}
+
+int RSIObject::applicationTime( const QString& application )
+{
+    return RSIGlobals::instance()->appUsage()->seconds( application );
+}
@@ -21,12 +21,16 @@
 #ifndef RSIWIDGET_H
 #define RSIWIDGET_H
 
+#include "rsiconfig.h"
 #include "rsitimer.h"
 #include "notificator.h"
+#include "progressicon.h"
 
 class RSIDock;
 class RSIRelaxPopup;
 class BreakBase;
+class ConfigWatcher;
+class InhibitionWatcher;
 
 /**
  * @class RSIObject
@@ -40,7 +44,7 @@ class RSIObject : public QObject
 
 public:
 
-    enum Effects {  SimpleGray = 0, Plasma, SlideShow, Popup };
+    enum Effects {  SimpleGray = 0, Plasma, SlideShow, Popup, Blur };
 
     /**
      * Constructor
@@ -68,31 +72,50 @@ private slots:
     void maximize();
     void setCounters( int );
     void updateIdleAvg( double );
+    void prepareBreak( int tinyLeft, int bigLeft );
+    void relaxing( int secondsLeft );
     void readConfig();
+    void slotConfigFileChanged( const RSIConfig& config );
     void tinyBreakSkipped();
     void bigBreakSkipped();
 
 protected:
-    /** Sets appropriate icon in tooltip and docker. */
-    void setIcon( int );
+    /**
+     * Sets appropriate icon in tooltip and docker.
+     * @param progress time passed until the next tiny break, 0 to 100.
+     */
+    void setIcon( double progress );
 
 private:
     void findImagesInFolder( const QString& folder );
     void loadImage();
     void configureTimer();
+    void createEffect();
+    void applyConfig( const RSIConfig& config );
 
     RSIDock*        m_tray;
     RSITimer*       m_timer;
     BreakBase*      m_effect;
 
-    bool            m_useImages;
+    // The settings currently applied, to find what a reload changes.
+    RSIConfig       m_config;
+    // Read from a changed file during a break, applied once it is over.
+    std::unique_ptr<RSIConfig> m_deferredConfig;
 
-    bool            m_usePlasma;
-    bool            m_usePlasmaRO;
+    ConfigWatcher*  m_configWatcher;
+    InhibitionWatcher* m_inhibitionWatcher;
 
     RSIRelaxPopup*  m_relaxpopup;
 
+    // Whether m_effect has been asked to prepare for the coming break.
+    bool            m_effectPrepared;
+    // Whether a break is announced or running, resources must stay then.
+    bool            m_breakPending;
+
     QString         m_currentIcon;
+    ProgressIcon    m_progressIcon;
+    // Frame of m_progressIcon in the tray, to skip unchanged updates.
+    int             m_iconFrame;
 
     Notificator     m_notificator;
 
@@ -112,6 +135,10 @@ public Q_SLOTS:
     QString currentIcon() {
         return m_currentIcon;
     }
+    /** Window classes of the applications used longest today, longest first. */
+    QStringList topApplications( int count );
+    /** Seconds @p application was active today. */
+    int applicationTime( const QString& application );
 };
 
 #   endif
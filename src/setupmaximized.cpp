@@ -92,6 +92,7 @@ SetupMaximized::SetupMaximized( QWidget* parent )
     d->effectBox->addItem( i18n( "Show Plasma Dashboard" ), QVariant( RSIObject::Plasma ) );
     d->effectBox->addItem( i18n( "Show Slide Show of Images" ), QVariant( RSIObject::SlideShow ) );
     d->effectBox->addItem( i18n( "Show a Passive Popup" ), QVariant( RSIObject::Popup ) );
+    d->effectBox->addItem( i18n( "Show Blurred Desktop" ), QVariant( RSIObject::Blur ) );
     d->effectLabel->setBuddy( d->effectBox );
 
     connect(d->effectBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &SetupMaximized::slotEffectChanged);
@@ -168,7 +169,9 @@ SetupMaximized::SetupMaximized( QWidget* parent )
     d->imageFolderEdit = new QLineEdit( imageFolderBox );
     d->imageFolderEdit->setWhatsThis( i18n( "Select the folder from which you "
                                             "want to see images. These images are randomly shown during the breaks. "
-                                            "It will be searched recursively if you want..." ) );
+                                            "It will be searched recursively if you want... "
+                                            "You can also enter an image bundle created with rsibreak-bundle, "
+                                            "which avoids reading many small files during the break." ) );
     d->changePathButton = new QPushButton( i18n( "&Change..." ),
                                            imageFolderBox );
     imageFolderBoxHBoxLayout->addWidget(d->changePathButton);
@@ -293,6 +296,11 @@ void SetupMaximized::slotEffectChanged( int current )
         d->plasmaBox->setVisible( false );
         d->grayBox->setVisible( KWindowSystem::compositingActive() );
         break;
+    case RSIObject::Blur:
+        d->slideshowBox->setVisible( false );
+        d->plasmaBox->setVisible( false );
+        d->grayBox->setVisible( false );
+        break;
     case RSIObject::Popup:
     default:
         d->slideshowBox->setVisible( false );
@@ -23,6 +23,7 @@
 #include "setuptiming.h"
 
 // QT includes.
+#include <QCheckBox>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -44,6 +45,9 @@ public:
     KPluralHandlingSpinBox*          bigDuration;
     KPluralHandlingSpinBox*          bigThreshold;
     KPluralHandlingSpinBox*          postponeDuration;
+    KPluralHandlingSpinBox*          activityBudget;
+    KPluralHandlingSpinBox*          activityWindow;
+    QCheckBox*                       inputIntensity;
     int                    debug;
 };
 
@@ -176,10 +180,57 @@ SetupTiming::SetupTiming( QWidget* parent )
     vbox2->addWidget( m5 );
     vbox2->addStretch( 1 );
     postponeBox->setLayout( vbox2 );    
-    
+
+    // ------------------------ Activity budget
+
+    QGroupBox *budgetBox = new QGroupBox( this );
+    budgetBox->setTitle( i18n( "Activity Limit" ) );
+
+    QWidget *m6 = new QWidget( this );
+    QHBoxLayout *m6HBoxLayout = new QHBoxLayout(m6);
+    m6HBoxLayout->setMargin(0);
+    QLabel *l6 = new QLabel( i18n( "Long break after being active for:" ) + ' ', m6 );
+    m6HBoxLayout->addWidget(l6);
+    l6->setAlignment( Qt::AlignRight | Qt::AlignVCenter );
+    l6->setWhatsThis( i18n( "Here you can set how much time you may be active within the "
+                            "period below, short pauses included. When that time is used up "
+                            "a long break follows." ) );
+    d->activityBudget = new KPluralHandlingSpinBox( m6 );
+    m6HBoxLayout->addWidget(d->activityBudget);
+    d->activityBudget->setRange( 0, 1000 );
+    d->activityBudget->setSpecialValueText( i18n( "Off" ) );
+    l6->setBuddy( d->activityBudget );
+
+    QWidget *m7 = new QWidget( this );
+    QHBoxLayout *m7HBoxLayout = new QHBoxLayout(m7);
+    m7HBoxLayout->setMargin(0);
+    QLabel *l7 = new QLabel( i18n( "Within any period of:" ) + ' ', m7 );
+    m7HBoxLayout->addWidget(l7);
+    l7->setAlignment( Qt::AlignRight | Qt::AlignVCenter );
+    l7->setWhatsThis( i18n( "Here you can set the length of the period in which the active time is counted." ) );
+    d->activityWindow = new KPluralHandlingSpinBox( m7 );
+    m7HBoxLayout->addWidget(d->activityWindow);
+    d->activityWindow->setRange( 1, 1440 );
+    l7->setBuddy( d->activityWindow );
+    connect( d->activityWindow,  static_cast<void ( KPluralHandlingSpinBox::* )( int )>( &KPluralHandlingSpinBox::valueChanged ),
+             this, &SetupTiming::slotActivityWindowValueChanged );
+
+    d->inputIntensity = new QCheckBox( i18n( "Count intense typing and clicking faster" ), budgetBox );
+    d->inputIntensity->setWhatsThis( i18n( "With this option enabled, every second of activity "
+                                           "counts double toward your breaks while you type and "
+                                           "click a lot. This needs an X11 session." ) );
+
+    QVBoxLayout *vbox3 = new QVBoxLayout( budgetBox );
+    vbox3->addWidget( m6 );
+    vbox3->addWidget( m7 );
+    vbox3->addWidget( d->inputIntensity );
+    vbox3->addStretch( 1 );
+    budgetBox->setLayout( vbox3 );
+
     l->addWidget( tinyBox );
     l->addWidget( bigBox );
     l->addWidget( postponeBox );
+    l->addWidget( budgetBox );
     setLayout( l );
     readSettings();
 
@@ -192,6 +243,10 @@ SetupTiming::SetupTiming( QWidget* parent )
     d->tinyDuration->setSuffix( ki18np( " second", " seconds" ) );
     d->debug ? d->postponeDuration->setSuffix( ki18np( " second", " seconds" ) )
     : d->postponeDuration->setSuffix( ki18np( " minute", " minutes" ) );
+    d->debug ? d->activityBudget->setSuffix( ki18np( " second", " seconds" ) )
+    : d->activityBudget->setSuffix( ki18np( " minute", " minutes" ) );
+    d->debug ? d->activityWindow->setSuffix( ki18np( " second", " seconds" ) )
+    : d->activityWindow->setSuffix( ki18np( " minute", " minutes" ) );
 
     d->tinyThreshold->setSuffix( ki18np( " second", " seconds" ) );
     d->bigThreshold->setSuffix( ki18np( " minute", " minutes" ) );
@@ -206,6 +261,8 @@ SetupTiming::SetupTiming( QWidget* parent )
     d->tinyThreshold->setFixedSize( d->tinyThreshold->sizeHint() );
     d->bigThreshold->setFixedSize( d->bigThreshold->sizeHint() );
     d->postponeDuration->setFixedSize( d->tinyInterval->sizeHint() );
+    d->activityBudget->setFixedSize( d->tinyInterval->sizeHint() );
+    d->activityWindow->setFixedSize( d->tinyInterval->sizeHint() );
 }
 
 SetupTiming::~SetupTiming()
@@ -223,6 +280,9 @@ void SetupTiming::applySettings()
     config.writeEntry( "BigDuration", d->bigDuration->value() );
     config.writeEntry( "BigThreshold", d->bigThreshold->value() );
     config.writeEntry( "PostponeBreakDuration", d->postponeDuration->value() );
+    config.writeEntry( "ActivityBudget", d->activityBudget->value() );
+    config.writeEntry( "ActivityWindow", d->activityWindow->value() );
+    config.writeEntry( "UseInputIntensity", d->inputIntensity->isChecked() );
     config.sync();
 }
 
@@ -241,6 +301,10 @@ void SetupTiming::readSettings()
     d->bigThreshold->setValue( config.readEntry( "BigThreshold", 5 ) );
     d->bigThreshold->setMinimum( d->bigDuration->value() );
     d->postponeDuration->setValue( config.readEntry( "PostponeBreakDuration", 5 ) );
+    d->activityWindow->setValue( config.readEntry( "ActivityWindow", 60 ) );
+    d->activityBudget->setMaximum( d->activityWindow->value() );
+    d->activityBudget->setValue( config.readEntry( "ActivityBudget", 0 ) );
+    d->inputIntensity->setChecked( config.readEntry( "UseInputIntensity", false ) );
 }
 
 void SetupTiming::slotTinyValueChanged( const int tinyIntervalValue  )
@@ -258,6 +322,11 @@ void SetupTiming::slotTinyDurationValueChanged( const int tinyDurationValue )
     d->tinyThreshold->setMinimum( tinyDurationValue );
 }
 
+void SetupTiming::slotActivityWindowValueChanged( const int activityWindowValue )
+{
+    d->activityBudget->setMaximum( activityWindowValue );
+}
+
 void SetupTiming::slotSetUseIdleTimer( const bool useIdleTimer )
 {
     d->bigThreshold->setEnabled( useIdleTimer );
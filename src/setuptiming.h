@@ -60,6 +60,7 @@ private slots:
     void slotTinyValueChanged( const int tinyIntervalValue );
     void slotTinyDurationValueChanged( const int tinyDurationValue );
     void slotBigDurationValueChanged( const int bigDurationValue );
+    void slotActivityWindowValueChanged( const int activityWindowValue );
 
 private:
     void readSettings();
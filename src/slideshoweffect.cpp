@@ -19,30 +19,131 @@
 
 #include "slideshoweffect.h"
 #include "breakbase.h"
+#include "imagescaler.h"
 
 #include <QApplication>
+#include <QBuffer>
 #include <QDebug>
-#include <QDesktopWidget>
 #include <QDir>
+#include <QImageReader>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScreen>
 #include <QTimer>
-#include <QVBoxLayout>
-#include <QLabel>
+#include <QtConcurrent>
 
 #include <KWindowSystem>
 
+namespace
+{
+
+// Rounds of replacing rejected images before giving up on a slide.
+const int MAX_LOAD_ROUNDS = 10;
+
+/*
+  Everything needed to put one image on one screen. Jobs for all screens
+  run in parallel, so they only touch their own buffers.
+*/
+struct SlideJob {
+    enum Result { Shown, TooSmall, Unreadable };
+
+    SlideWidget* widget;
+    QString file;
+    int bundleIndex;
+    QImage* decoded;
+    QImage* frame;
+    QColor background;
+    int minImageSurface;
+    Result result;
+};
+
+class SlideRenderer
+{
+public:
+    typedef void result_type;
+
+    SlideRenderer( const ImageBundle* bundle, bool showSmallImages, bool expand )
+        : m_bundle( bundle ), m_showSmallImages( showSmallImages ), m_expand( expand ) {}
+
+    void operator()( SlideJob& job ) const {
+        job.result = decode( job );
+        if ( job.result == SlideJob::Shown )
+            render( job );
+    }
+
+private:
+    SlideJob::Result decode( SlideJob& job ) const {
+        // The bundle is mapped, so reading it from several threads is fine.
+        QBuffer buffer;
+        QImageReader reader;
+        if ( job.bundleIndex >= 0 ) {
+            buffer.setData( m_bundle->rawData( job.bundleIndex ) );
+            buffer.open( QIODevice::ReadOnly );
+            reader.setDevice( &buffer );
+        } else {
+            reader.setFileName( job.file );
+        }
+
+        // The header tells the size, so small images are not decoded at all.
+        const QSize imageSize = reader.size();
+        if ( !m_showSmallImages && imageSize.isValid() &&
+                imageSize.width() * imageSize.height() < job.minImageSurface )
+            return SlideJob::TooSmall;
+
+        if ( !reader.read( job.decoded ) )
+            return SlideJob::Unreadable;
+
+        if ( !m_showSmallImages && job.decoded->width() * job.decoded->height() < job.minImageSurface )
+            return SlideJob::TooSmall;
+
+        return SlideJob::Shown;
+    }
+
+    void render( SlideJob& job ) const {
+        const QImage& image = *job.decoded;
+        QImage* frame = job.frame;
+
+        const Qt::AspectRatioMode mode = m_expand ? Qt::KeepAspectRatioByExpanding
+                                                  : Qt::KeepAspectRatio;
+        QRect target( QPoint( 0, 0 ), image.size().scaled( frame->size(), mode ) );
+        target.moveCenter( frame->rect().center() );
+
+        QPainter painter( frame );
+        if ( !target.contains( frame->rect() ) || image.hasAlphaChannel() )
+            painter.fillRect( frame->rect(), job.background );
+
+        if ( image.hasAlphaChannel() ) {
+            painter.setRenderHint( QPainter::SmoothPixmapTransform );
+            painter.drawImage( target, image );
+            painter.end();
+        } else {
+            // Photos are opaque, scale them straight into the frame. Only the
+            // visible part of an expanded image is computed.
+            painter.end();
+            ImageScaler::scale( image, frame, target );
+        }
+    }
+
+    const ImageBundle* m_bundle;
+    bool m_showSmallImages;
+    bool m_expand;
+};
+
+}
 
 SlideEffect::SlideEffect( QObject *parent )
         : BreakBase( parent ), m_searchRecursive( false ), m_showSmallImages( false )
 {
-    // Make all other screens gray...
-    slotGray();
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &SlideEffect::slotGray );
-
-    m_slidewidget = new SlideWidget( 0 );
-    KWindowSystem::forceActiveWindow( m_slidewidget->winId() );
-    KWindowSystem::setOnAllDesktops( m_slidewidget->winId(), true );
-    KWindowSystem::setState( m_slidewidget->winId(), NET::KeepAbove );
-    KWindowSystem::setState( m_slidewidget->winId(), NET::FullScreen );
+    // Every screen shows its own slides, so no screen is grayed.
+    m_screens = new ScreenWidgets( [this]( QScreen* screen ) {
+        SlideWidget* widget = new SlideWidget( screen );
+        // The widget follows the geometry itself, then gets a slide that fits.
+        connect( screen, &QScreen::geometryChanged, widget, [this, widget] {
+            loadImages( QVector<SlideWidget*>() << widget );
+        } );
+        return widget;
+    }, this );
+    connect( m_screens, &ScreenWidgets::added, this, &SlideEffect::slotScreenAdded );
 
     setReadOnly( true );
 
@@ -50,26 +151,47 @@ SlideEffect::SlideEffect( QObject *parent )
     connect(m_timer_slide, &QTimer::timeout, this, &SlideEffect::slotNewSlide);
 }
 
-SlideEffect::~SlideEffect()
+SlideEffect::~SlideEffect() {}
+
+void SlideEffect::slotScreenAdded( ScreenWidget* widget )
 {
-    delete m_slidewidget;
+    loadImages( QVector<SlideWidget*>() << static_cast<SlideWidget*>( widget ) );
+    if ( m_timer_slide->isActive() )
+        widget->show();
 }
 
-void SlideEffect::slotGray()
+bool SlideEffect::hasImages()
 {
-    // Make all other screens gray...
-    setGrayEffectOnAllScreens( true );
-    excludeGrayEffectOnScreen( QApplication::desktop()->primaryScreen() );
+    return m_files.count() > 0 || m_bundle.count() > 0;
 }
 
-bool SlideEffect::hasImages()
+void SlideEffect::prepare()
+{
+    if ( !hasImages() || !m_screens->prepare() )
+        return;
+
+    foreach( SlideWidget* widget, m_screens->widgets<SlideWidget>() ) {
+        if ( widget->screen() == QGuiApplication::primaryScreen() )
+            KWindowSystem::forceActiveWindow( widget->winId() );
+    }
+
+    loadImage();
+}
+
+void SlideEffect::release()
 {
-    return m_files.count() > 0;
+    m_timer_slide->stop();
+
+    // The widgets keep screen sized buffers, drop them with the widgets.
+    m_screens->release();
 }
 
 void SlideEffect::activate()
 {
-    m_slidewidget->show();
+    // Normally done by RSIObject a few seconds in advance.
+    prepare();
+
+    m_screens->show();
     m_timer_slide->start( m_slideInterval*1000 );
     BreakBase::activate();
 }
@@ -77,67 +199,114 @@ void SlideEffect::activate()
 void SlideEffect::deactivate()
 {
     m_timer_slide->stop();
-    m_slidewidget->hide();
+    m_screens->hide();
     BreakBase::deactivate();
+    release();
 }
 
 void SlideEffect::loadImage()
 {
-    if ( m_files.count() == 0 )
+    loadImages( m_screens->widgets<SlideWidget>() );
+}
+
+void SlideEffect::loadImages( const QVector<SlideWidget*>& widgets )
+{
+    if ( widgets.isEmpty() || !hasImages() )
         return;
 
-    // Base the size on the size of the screen, for xinerama.
-    QRect size = QApplication::desktop()->screenGeometry(
-                     QApplication::desktop()->primaryScreen() );
-
-    // Do not accept images whose surface is more than 3 times smaller than
-    // screen
-    int min_image_surface = size.width() * size.height() / 3;
-    QImage image;
-
-    while ( true ) {
-        // reset if all images are shown
-        if ( m_files_done.count() == m_files.count() )
-            m_files_done.clear();
-
-        // get a not yet used image
-        int j;
-        QString name;
-        do {
-            j = ( int )( m_files.count() * ( qrand() / ( RAND_MAX + 1.0 ) ) );
-            name = m_files[ j ];
-        } while ( m_files_done.indexOf( name ) != -1 );
-
-        // load image
-        qDebug() << "Loading:" << name << "(" << j << "/"  << m_files.count() << ") ";
-        image.load( name );
-
-        // Check size
-        if ( image.width() * image.height() >= min_image_surface || m_showSmallImages ) {
-            // Image is big enough, leave while loop
-            m_files_done.append( name );
-            break;
-        } else {
-            // Too small, remove from list
-            m_files.removeAll( name );
-            if ( m_files.count() == 0 ) {
-                // Couldn't find any image big enough, leave function
-                return;
+    QVector<SlideJob> pending;
+    foreach( SlideWidget* widget, widgets ) {
+        SlideJob job;
+        job.widget = widget;
+        job.bundleIndex = -1;
+        job.decoded = widget->decodeBuffer();
+        job.frame = widget->nextFrame();
+        job.background = widget->palette().color( QPalette::Window );
+        // Do not accept images whose surface is more than 3 times smaller
+        // than the screen. Bundles are already scaled to the size they were
+        // made for, they are shown whatever the screen.
+        job.minImageSurface = m_bundle.isOpen() ? 0 : job.frame->width() * job.frame->height() / 3;
+        job.result = SlideJob::Unreadable;
+        pending.append( job );
+    }
+
+    // Pick the images here, decode and scale them in parallel, then replace
+    // the ones that were rejected for another round.
+    for ( int round = 0; round < MAX_LOAD_ROUNDS && !pending.isEmpty() && hasImages(); ++round ) {
+        for ( int i = 0; i < pending.count(); ++i ) {
+            if ( m_bundle.isOpen() )
+                pending[i].bundleIndex = nextBundleIndex();
+            else
+                pending[i].file = nextFile();
+        }
+        if ( m_bundle.isOpen() && pending.first().bundleIndex < 0 )
+            return;
+
+        QtConcurrent::blockingMap( pending, SlideRenderer( &m_bundle, m_showSmallImages,
+                                                           m_expandImageToFullScreen ) );
+
+        QVector<SlideJob> rejected;
+        foreach( const SlideJob& job, pending ) {
+            if ( job.result == SlideJob::Shown ) {
+                job.widget->setFrame( job.frame );
+                continue;
             }
+
+            if ( job.bundleIndex < 0 ) {
+                // Too small or broken, do not try this file again.
+                qDebug() << "Skipping:" << job.file;
+                m_files.removeAll( job.file );
+                m_files_done.removeAll( job.file );
+            }
+            rejected.append( job );
         }
+        pending = rejected;
     }
+}
 
-    const Qt::AspectRatioMode mode = ( m_expandImageToFullScreen ) ? Qt::KeepAspectRatioByExpanding
-                                                             : Qt::KeepAspectRatio;
-    const QImage m( image.scaled( size.width(), size.height(), mode ) );
+QString SlideEffect::nextFile()
+{
+    if ( m_files.isEmpty() )
+        return QString();
+
+    // reset if all images are shown
+    if ( m_files_done.count() >= m_files.count() )
+        m_files_done.clear();
+
+    // get a not yet used image
+    int j;
+    QString name;
+    do {
+        j = ( int )( m_files.count() * ( qrand() / ( RAND_MAX + 1.0 ) ) );
+        name = m_files[ j ];
+    } while ( m_files_done.indexOf( name ) != -1 );
+
+    qDebug() << "Loading:" << name << "(" << j << "/"  << m_files.count() << ") ";
+    m_files_done.append( name );
+    return name;
+}
 
-    if ( m.isNull() )
-        return;
+int SlideEffect::nextBundleIndex()
+{
+    // Every image is shown once before repeating.
+    if ( m_bundleQueue.isEmpty() ) {
+        for ( int i = 0; i < m_bundle.count(); ++i )
+            m_bundleQueue.append( i );
+        if ( m_bundleQueue.isEmpty() )
+            return -1;
+
+        // Fisher-Yates, so the order differs each round.
+        for ( int i = m_bundleQueue.count() - 1; i > 0; --i ) {
+            const int j = ( int )( ( i + 1 ) * ( qrand() / ( RAND_MAX + 1.0 ) ) );
+            qSwap( m_bundleQueue[i], m_bundleQueue[j] );
+        }
+    }
 
-    m_slidewidget->setImage( m );
+    const int index = m_bundleQueue.takeLast();
+    qDebug() << "Loading bundle image" << index << "/" << m_bundle.count();
+    return index;
 }
 
-
 void SlideEffect::findImagesInFolder( const QString& folder )
 {
     if ( folder.isNull() )
@@ -175,7 +344,8 @@ void SlideEffect::findImagesInFolder( const QString& folder )
 
 void SlideEffect::slotNewSlide()
 {
-    if ( m_files.count() == 1 )
+    // With one image per screen there is nothing new to show.
+    if ( ( m_bundle.isOpen() ? m_bundle.count() : m_files.count() ) <= m_screens->count() )
         return;
 
     loadImage();
@@ -183,48 +353,59 @@ void SlideEffect::slotNewSlide()
 
 void SlideEffect::reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int slideInterval )
 {
+    release();
     m_files.clear();
     m_files_done.clear();
+    m_bundle.close();
+    m_bundleQueue.clear();
     m_basePath = path;
     m_searchRecursive = recursive;
     m_showSmallImages = showSmallImages;
     m_slideInterval = slideInterval;
     m_expandImageToFullScreen = expandImageToFullScreen;
 
-    findImagesInFolder( path );
-    qDebug() << "Amount of Files:" << m_files.count();
-    QTimer::singleShot( 2000, this, &SlideEffect::slotNewSlide );
+    // A bundle is a single mapped file, so showing a slide does not touch
+    // the file system at all.
+    if ( ImageBundle::isBundle( path ) && m_bundle.open( path ) ) {
+        qDebug() << "Amount of images in bundle:" << m_bundle.count();
+    } else {
+        findImagesInFolder( path );
+        qDebug() << "Amount of Files:" << m_files.count();
+    }
 }
 
 // ------------------ Show widget
 
 
-SlideWidget::SlideWidget( QWidget *parent )
-        : QWidget( parent, Qt::Popup )
+SlideWidget::SlideWidget( QScreen* screen, QWidget *parent )
+        : ScreenWidget( screen, parent ), m_ratio( 1.0 ), m_frame( nullptr )
 {
-    slotDimension();
-    connect( QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &SlideWidget::slotDimension );
-
-    QVBoxLayout *boxLayout = new QVBoxLayout( this );
-    boxLayout->setSpacing(0);
-    boxLayout->setContentsMargins(0, 0, 0, 0);
-    setLayout( boxLayout );
-    m_imageLabel = new QLabel();
-    m_imageLabel->setMaximumSize( width(), height() );
-    m_imageLabel->setAlignment( Qt::AlignCenter );
-    layout()->addWidget(m_imageLabel);
 }
 
 SlideWidget::~SlideWidget() {}
 
-void SlideWidget::slotDimension()
+QImage* SlideWidget::nextFrame()
+{
+    m_ratio = screen()->devicePixelRatio();
+
+    // The frames stay in device pixels, the ratio is applied when painting.
+    return m_framePool.acquire( size() * m_ratio );
+}
+
+void SlideWidget::setFrame( const QImage* frame )
 {
-    QRect rect = QApplication::desktop()->screenGeometry(
-                     QApplication::desktop()->primaryScreen() );
-    setGeometry( rect );
+    m_framePool.present( frame );
+    m_frame = frame;
+    update();
 }
 
-void SlideWidget::setImage( const QImage &image )
+void SlideWidget::paintEvent( QPaintEvent* event )
 {
-    m_imageLabel->setPixmap( QPixmap::fromImage(image) );
+    QPainter painter( this );
+    if ( m_frame && !m_frame->isNull() ) {
+        const QRect source( event->rect().topLeft() * m_ratio, event->rect().size() * m_ratio );
+        painter.drawImage( event->rect(), *m_frame, source );
+    } else {
+        painter.fillRect( event->rect(), palette().color( QPalette::Window ) );
+    }
 }
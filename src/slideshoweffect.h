@@ -21,11 +21,15 @@
 #ifndef SLIDESHOW_H
 #define SLIDESHOW_H
 
+#include <QImage>
+#include <QVector>
 #include <QWidget>
 #include "breakbase.h"
+#include "framebufferpool.h"
+#include "imagebundle.h"
 
+class QScreen;
 class SlideWidget;
-class QLabel;
 
 class SlideEffect : public BreakBase
 {
@@ -37,17 +41,27 @@ public:
     void reset( const QString& path, bool recursive, bool showSmallImages, bool expandImageToFullScreen, int interval );
     void activate() override;
     void deactivate() override;
+    void prepare() override;
+    void release() override;
     bool hasImages();
+
+    /**
+     * Shows a new image on every screen. The images are decoded and scaled
+     * in parallel, one per screen.
+     */
     void loadImage();
 
 private slots:
-    void slotGray();
+    void slotScreenAdded( ScreenWidget* widget );
     void slotNewSlide();
 
 private:
+    void loadImages( const QVector<SlideWidget*>& widgets );
     void findImagesInFolder( const QString& folder );
+    QString nextFile();
+    int nextBundleIndex();
 
-    SlideWidget*    m_slidewidget;
+    ScreenWidgets*  m_screens;
     QString         m_basePath;
     QTimer*         m_timer_slide;
 
@@ -58,32 +72,55 @@ private:
 
     QStringList     m_files;
     QStringList     m_files_done;
+
+    ImageBundle     m_bundle;
+    QVector<int>    m_bundleQueue;
 };
 
-class SlideWidget : public QWidget
+class SlideWidget : public ScreenWidget
 {
     Q_OBJECT
 public:
     /**
      * Constructor
+     * @param screen The screen to cover, followed when its geometry changes
      * @param parent Parent Widget
-     * @param name Name
      */
-    explicit SlideWidget( QWidget *parent = 0 );
+    explicit SlideWidget( QScreen* screen, QWidget *parent = 0 );
 
     /**
      * Destructor
      */
     ~SlideWidget();
 
-    void setImage( const QImage &image );
+    /**
+     * @returns the next buffer to render into, sized to the screen in
+     * device pixels, so images stay sharp on high DPI screens.
+     */
+    QImage* nextFrame();
 
-private slots:
-    void slotDimension();
+    /**
+     * @returns the image the slides of this screen are decoded into. It is
+     * kept so decoding does not allocate while the image size stays the same.
+     */
+    QImage* decodeBuffer() {
+        return &m_decoded;
+    }
 
-private:
-    QLabel *m_imageLabel;
+    /**
+     * Shows @p frame, a buffer returned by nextFrame().
+     * The widget only keeps the pointer, so the buffer is not copied.
+     */
+    void setFrame( const QImage* frame );
+
+protected:
+    void paintEvent( QPaintEvent* event ) override;
 
+private:
+    qreal m_ratio;
+    FrameBufferPool m_framePool;
+    QImage m_decoded;
+    const QImage* m_frame;
 };
 
 #   endif
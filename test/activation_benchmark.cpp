@@ -0,0 +1,288 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+   Measures how long the break effects take to cover the screens.
+
+   Without arguments the benchmark starts itself once per screen count,
+   1 to 4, on the offscreen platform with that many virtual screens. Each
+   run reports for every effect the percentiles of:
+     prepare     what RSIObject does a few seconds before the break
+     activate    the activate() call itself
+     painted     from activate() until every shown window got painted
+     deactivate  from deactivate() until every window is hidden again
+
+   Multiple offscreen screens need a Qt whose offscreen platform reads a
+   configfile; with an older Qt the runs with more than one screen are
+   reported as skipped.
+*/
+
+#include "blureffect.h"
+#include "grayeffect.h"
+#include "plasmaeffect.h"
+#include "popupeffect.h"
+#include "slideshoweffect.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QProcess>
+#include <QScreen>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QWidget>
+
+#include <algorithm>
+#include <memory>
+#include <stdlib.h>
+
+static const int MAX_SCREENS = 4;
+static const int DEFAULT_ITERATIONS = 50;
+static const int PAINT_TIMEOUT_MS = 2000;
+
+// Remembers which windows were painted since the last reset().
+class PaintSpy : public QObject
+{
+public:
+    void reset() {
+        m_painted.clear();
+    }
+
+    bool allPainted() const {
+        foreach( QWidget* widget, QApplication::topLevelWidgets() ) {
+            if ( widget->isVisible() && !m_painted.contains( widget ) )
+                return false;
+        }
+        return true;
+    }
+
+protected:
+    bool eventFilter( QObject* obj, QEvent* event ) override {
+        if ( event->type() == QEvent::Paint && obj->isWidgetType() &&
+                static_cast<QWidget*>( obj )->isWindow() )
+            m_painted.insert( static_cast<QWidget*>( obj ) );
+        return false;
+    }
+
+private:
+    QSet<QWidget*> m_painted;
+};
+
+struct Samples {
+    QVector<qint64> prepare;
+    QVector<qint64> activate;
+    QVector<qint64> painted;
+    QVector<qint64> deactivate;
+};
+
+static bool anyVisible()
+{
+    foreach( QWidget* widget, QApplication::topLevelWidgets() ) {
+        if ( widget->isVisible() )
+            return true;
+    }
+    return false;
+}
+
+static void waitFor( bool ( *done )( const PaintSpy& ), const PaintSpy& spy )
+{
+    QElapsedTimer timeout;
+    timeout.start();
+    while ( !done( spy ) && timeout.elapsed() < PAINT_TIMEOUT_MS )
+        QCoreApplication::processEvents( QEventLoop::AllEvents, 5 );
+}
+
+static Samples measure( BreakBase* effect, int iterations, PaintSpy& spy )
+{
+    Samples samples;
+    QElapsedTimer timer;
+
+    for ( int i = 0; i < iterations; ++i ) {
+        timer.start();
+        effect->prepare();
+        samples.prepare.append( timer.nsecsElapsed() );
+
+        spy.reset();
+        timer.start();
+        effect->activate();
+        samples.activate.append( timer.nsecsElapsed() );
+        waitFor( []( const PaintSpy & s ) { return s.allPainted(); }, spy );
+        samples.painted.append( timer.nsecsElapsed() );
+
+        timer.start();
+        effect->deactivate();
+        waitFor( []( const PaintSpy& ) { return !anyVisible(); }, spy );
+        samples.deactivate.append( timer.nsecsElapsed() );
+    }
+
+    return samples;
+}
+
+static QString percentiles( QVector<qint64> values )
+{
+    std::sort( values.begin(), values.end() );
+    const auto at = [&values]( double p ) {
+        const int index = qMin( values.count() - 1, int( p * values.count() ) );
+        return QString::number( values[index] / 1e6, 'f', 2 );
+    };
+
+    return QString( "%1 %2 %3 %4" ).arg( at( 0.50 ), 9 ).arg( at( 0.90 ), 9 )
+           .arg( at( 0.99 ), 9 ).arg( QString::number( values.last() / 1e6, 'f', 2 ), 9 );
+}
+
+static void report( QTextStream& out, int screens, const QString& effect, const Samples& samples )
+{
+    const QString row = QString( "%1 %2 %3 " ).arg( screens, 7 ).arg( effect, -8 );
+    out << row.arg( "prepare", -10 ) << percentiles( samples.prepare ) << endl;
+    out << row.arg( "activate", -10 ) << percentiles( samples.activate ) << endl;
+    out << row.arg( "painted", -10 ) << percentiles( samples.painted ) << endl;
+    out << row.arg( "deactivate", -10 ) << percentiles( samples.deactivate ) << endl;
+}
+
+static QString createImages( const QTemporaryDir& dir )
+{
+    // Camera sized pictures, so decoding and scaling show up in the numbers.
+    for ( int i = 0; i < 8; ++i ) {
+        QImage image( 4000, 3000, QImage::Format_RGB32 );
+        QPainter painter( &image );
+        QLinearGradient gradient( 0, 0, image.width(), image.height() );
+        gradient.setColorAt( 0, QColor::fromHsv( i * 40, 255, 128 ) );
+        gradient.setColorAt( 1, Qt::white );
+        painter.fillRect( image.rect(), gradient );
+        painter.end();
+        image.save( dir.path() + QString( "/slide%1.jpg" ).arg( i ), "JPEG", 90 );
+    }
+    return dir.path();
+}
+
+static int runEffects( int argc, char* argv[], int screens, int iterations )
+{
+    QApplication app( argc, argv );
+    QTextStream out( stdout );
+
+    if ( QGuiApplication::screens().count() != screens ) {
+        out << QString( "%1 skipped, the platform provides %2 screen(s)" )
+            .arg( screens, 7 ).arg( QGuiApplication::screens().count() ) << endl;
+        return 0;
+    }
+
+    PaintSpy spy;
+    app.installEventFilter( &spy );
+
+    QTemporaryDir images;
+    const QString folder = createImages( images );
+
+    {
+        std::unique_ptr<GrayEffect> effect( new GrayEffect( 0 ) );
+        effect->setLevel( 80 );
+        report( out, screens, "gray", measure( effect.get(), iterations, spy ) );
+    }
+    {
+        std::unique_ptr<SlideEffect> effect( new SlideEffect( 0 ) );
+        effect->reset( folder, false, true, true, 10 );
+        report( out, screens, "slide", measure( effect.get(), iterations, spy ) );
+    }
+    {
+        std::unique_ptr<PopupEffect> effect( new PopupEffect( 0 ) );
+        report( out, screens, "popup", measure( effect.get(), iterations, spy ) );
+    }
+    {
+        std::unique_ptr<BlurEffect> effect( new BlurEffect( 0 ) );
+        report( out, screens, "blur", measure( effect.get(), iterations, spy ) );
+    }
+    {
+        // Without a Plasma shell on the bus this measures the failing call.
+        std::unique_ptr<PlasmaEffect> effect( new PlasmaEffect( 0 ) );
+        report( out, screens, "plasma", measure( effect.get(), iterations, spy ) );
+    }
+
+    return 0;
+}
+
+static bool writeScreenConfig( const QString& path, int screens )
+{
+    QJsonArray list;
+    for ( int i = 0; i < screens; ++i ) {
+        QJsonObject screen;
+        screen["name"] = QString( "Offscreen%1" ).arg( i );
+        screen["x"] = i * 1920;
+        screen["y"] = 0;
+        screen["width"] = 1920;
+        screen["height"] = 1080;
+        screen["logicalDpi"] = 96;
+        screen["logicalBaseDpi"] = 96;
+        screen["dpr"] = 1;
+        list.append( screen );
+    }
+
+    QJsonObject config;
+    config["screens"] = list;
+
+    QFile file( path );
+    return file.open( QIODevice::WriteOnly ) &&
+           file.write( QJsonDocument( config ).toJson() ) > 0;
+}
+
+static int runAll( int argc, char* argv[], int iterations )
+{
+    QCoreApplication app( argc, argv );
+    QTextStream out( stdout );
+    QTemporaryDir dir;
+
+    out << "Break activation latency, " << iterations << " iterations, in ms" << endl;
+    out << "screens effect   phase            p50       p90       p99       max" << endl;
+
+    int status = 0;
+    for ( int screens = 1; screens <= MAX_SCREENS; ++screens ) {
+        const QString config = dir.path() + QString( "/screens%1.json" ).arg( screens );
+        if ( !writeScreenConfig( config, screens ) )
+            return 1;
+
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert( "QT_QPA_PLATFORM", "offscreen:configfile=" + config );
+
+        QProcess child;
+        child.setProcessEnvironment( env );
+        child.setProcessChannelMode( QProcess::ForwardedChannels );
+        child.start( app.applicationFilePath(), QStringList() << "--screens" << QString::number( screens )
+                     << "--iterations" << QString::number( iterations ) );
+        if ( !child.waitForFinished( -1 ) || child.exitCode() != 0 )
+            status = 1;
+    }
+
+    return status;
+}
+
+int main( int argc, char *argv[] )
+{
+    int screens = 0;
+    int iterations = DEFAULT_ITERATIONS;
+    for ( int i = 1; i + 1 < argc; ++i ) {
+        if ( qstrcmp( argv[i], "--screens" ) == 0 )
+            screens = qBound( 1, atoi( argv[i + 1] ), MAX_SCREENS );
+        else if ( qstrcmp( argv[i], "--iterations" ) == 0 )
+            iterations = qMax( 1, atoi( argv[i + 1] ) );
+    }
+
+    return screens > 0 ? runEffects( argc, argv, screens, iterations )
+                       : runAll( argc, argv, iterations );
+}
@@ -0,0 +1,81 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "configwatcher_test.h"
+
+#include "configwatcher.h"
+
+#include <QTemporaryDir>
+
+#include <KConfig>
+#include <KConfigGroup>
+
+namespace
+{
+
+void writeTinyInterval( const QString& fileName, int minutes )
+{
+    KConfig config( fileName, KConfig::SimpleConfig );
+    config.group( "General Settings" ).writeEntry( "TinyInterval", minutes );
+    config.sync();
+}
+
+}
+
+void ConfigWatcherTest::readChangedFile()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString fileName = dir.path() + "/rsibreakrc";
+    writeTinyInterval( fileName, 5 );
+
+    ConfigWatcher watcher( fileName );
+    QCOMPARE( watcher.files(), QStringList( fileName ) );
+    QSignalSpy spy( &watcher, &ConfigWatcher::configRead );
+
+    writeTinyInterval( fileName, 7 );
+    QVERIFY( spy.wait( 5000 ) );
+    QCOMPARE( spy.last().at( 0 ).value<RSIConfig>().intervals[TINY_BREAK_INTERVAL], 7 * 60 );
+
+    // KConfig replaces the file by a rename, it must still be watched.
+    writeTinyInterval( fileName, 9 );
+    QVERIFY( spy.wait( 5000 ) );
+    QCOMPARE( spy.last().at( 0 ).value<RSIConfig>().intervals[TINY_BREAK_INTERVAL], 9 * 60 );
+}
+
+void ConfigWatcherTest::createdLater()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString fileName = dir.path() + "/rsibreakrc";
+
+    ConfigWatcher watcher( fileName );
+    QVERIFY( watcher.files().isEmpty() );
+    QSignalSpy spy( &watcher, &ConfigWatcher::configRead );
+
+    // Unrelated files in the same directory are ignored.
+    QFile other( dir.path() + "/otherrc" );
+    QVERIFY( other.open( QIODevice::WriteOnly ) );
+    other.close();
+    QVERIFY( !spy.wait( 2 * ConfigWatcher::SETTLE_DELAY ) );
+
+    writeTinyInterval( fileName, 3 );
+    QVERIFY( spy.wait( 5000 ) );
+    QCOMPARE( spy.last().at( 0 ).value<RSIConfig>().intervals[TINY_BREAK_INTERVAL], 3 * 60 );
+    QCOMPARE( watcher.files(), QStringList( fileName ) );
+}
+
+#include "configwatcher_test.moc"
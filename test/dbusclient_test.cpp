@@ -0,0 +1,152 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "dbusclient_test.h"
+
+#include "dbusclient.h"
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+
+static const char* SERVICE_CONNECTION = "rsibreak-dbusclient-test";
+
+void DBusClientTest::initTestCase()
+{
+    m_service = nullptr;
+    if ( !QDBusConnection::sessionBus().isConnected() )
+        QSKIP( "No session bus" );
+
+    // The mocks live on their own connection, so calls take the real
+    // asynchronous path through the bus.
+    m_service = new QDBusConnection( QDBusConnection::connectToBus( QDBusConnection::SessionBus,
+                                                                    SERVICE_CONNECTION ) );
+    QVERIFY( m_service->isConnected() );
+    QVERIFY( m_service->registerObject( "/ScreenSaver", &m_screenSaver,
+                                        QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals ) );
+    QVERIFY( m_service->registerObject( "/PlasmaShell", &m_plasmaShell, QDBusConnection::ExportAllSlots ) );
+}
+
+void DBusClientTest::cleanupTestCase()
+{
+    if ( !m_service )
+        return;
+
+    m_service->unregisterObject( "/ScreenSaver" );
+    m_service->unregisterObject( "/PlasmaShell" );
+    delete m_service;
+    QDBusConnection::disconnectFromBus( SERVICE_CONNECTION );
+}
+
+void DBusClientTest::lockScreen()
+{
+    DBusClient client( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    QSignalSpy finished( &client, &DBusClient::finished );
+
+    client.lockScreen();
+    // Nothing happens before the event loop runs, the call does not block.
+    QCOMPARE( m_screenSaver.locks, 0 );
+
+    QVERIFY( finished.wait() );
+    QCOMPARE( finished.at( 0 ).at( 0 ).toString(), QString( "Lock" ) );
+    QCOMPARE( m_screenSaver.locks, 1 );
+}
+
+void DBusClientTest::screenLock()
+{
+    DBusClient client( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    QSignalSpy changed( &client, &DBusClient::screenLockChanged );
+
+    m_screenSaver.active = true;
+    client.queryScreenLock();
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), true );
+
+    emit m_screenSaver.ActiveChanged( false );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), false );
+    m_screenSaver.active = false;
+}
+
+void DBusClientTest::screenSaverRestart()
+{
+    const QString name = QStringLiteral( "org.rsibreak.TestScreenSaver" );
+    DBusClient client( QDBusConnection::sessionBus(), name, m_service->baseService() );
+    QSignalSpy changed( &client, &DBusClient::screenLockChanged );
+
+    // Locked when the screen saver crashes.
+    m_screenSaver.active = true;
+    QVERIFY( m_service->registerService( name ) );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), true );
+
+    QVERIFY( m_service->unregisterService( name ) );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), false );
+
+    // The new one is asked again.
+    QVERIFY( m_service->registerService( name ) );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), true );
+
+    m_service->unregisterService( name );
+    m_screenSaver.active = false;
+}
+
+void DBusClientTest::dashboard()
+{
+    DBusClient client( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    QSignalSpy finished( &client, &DBusClient::finished );
+
+    client.setDashboardShown( true );
+    QVERIFY( finished.wait() );
+    QVERIFY( m_plasmaShell.shown );
+
+    client.setDashboardShown( false );
+    QVERIFY( finished.wait() );
+    QVERIFY( !m_plasmaShell.shown );
+}
+
+void DBusClientTest::timeout()
+{
+    DBusClient client( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    client.setTimeout( 200 );
+    QSignalSpy failed( &client, &DBusClient::failed );
+
+    m_plasmaShell.hang = true;
+    QElapsedTimer timer;
+    timer.start();
+    client.setDashboardShown( true );
+    QVERIFY( timer.elapsed() < 100 );
+
+    QVERIFY( failed.wait( 2000 ) );
+    QCOMPARE( failed.at( 0 ).at( 0 ).toString(), QString( "setDashboardShown" ) );
+    QCOMPARE( failed.at( 0 ).at( 1 ).toString(), QString( "org.freedesktop.DBus.Error.NoReply" ) );
+
+    m_plasmaShell.hang = false;
+    m_plasmaShell.pending.clear();
+}
+
+void DBusClientTest::missingService()
+{
+    DBusClient client( QDBusConnection::sessionBus(), "org.rsibreak.NoSuchService",
+                       "org.rsibreak.NoSuchService" );
+    QSignalSpy failed( &client, &DBusClient::failed );
+
+    client.lockScreen();
+    QVERIFY( failed.wait() );
+}
+
+#include "dbusclient_test.moc"
@@ -0,0 +1,91 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_DBUSCLIENT_TEST_H
+#define RSIBREAK_DBUSCLIENT_TEST_H
+
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QtTest>
+
+class MockScreenSaver : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "D-Bus Interface", "org.freedesktop.ScreenSaver" )
+
+public:
+    MockScreenSaver() : locks( 0 ), active( false ) {}
+    int locks;
+
+    bool active;
+
+signals:
+    void ActiveChanged( bool active );
+
+public slots:
+    void Lock() {
+        ++locks;
+    }
+    bool GetActive() {
+        return active;
+    }
+};
+
+class MockPlasmaShell : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO( "D-Bus Interface", "org.kde.PlasmaShell" )
+
+public:
+    MockPlasmaShell() : shown( false ), hang( false ) {}
+    bool shown;
+
+    // Keeps the calls without answering, like a busy shell.
+    bool hang;
+    QList<QDBusMessage> pending;
+
+public slots:
+    void setDashboardShown( bool show ) {
+        if ( hang ) {
+            setDelayedReply( true );
+            pending.append( message() );
+            return;
+        }
+        shown = show;
+    }
+};
+
+class DBusClientTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void lockScreen();
+    void screenLock();
+    void screenSaverRestart();
+    void dashboard();
+    void timeout();
+    void missingService();
+
+private:
+    QDBusConnection* m_service;
+    MockScreenSaver m_screenSaver;
+    MockPlasmaShell m_plasmaShell;
+};
+
+#endif //RSIBREAK_DBUSCLIENT_TEST_H
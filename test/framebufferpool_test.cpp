@@ -0,0 +1,83 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "framebufferpool_test.h"
+
+#include "framebufferpool.h"
+
+#include <QPainter>
+
+void FrameBufferPoolTest::recycleBuffers()
+{
+    FrameBufferPool pool( 2 );
+    const QSize size( 64, 32 );
+
+    QImage* first = pool.acquire( size );
+    pool.present( first );
+    QImage* second = pool.acquire( size );
+    pool.present( second );
+    QVERIFY( first != second );
+    QCOMPARE( first->size(), size );
+    QCOMPARE( pool.allocations(), 2 );
+
+    // After warm-up, rendering into the buffers must not allocate.
+    for ( int i = 0; i < 10; ++i ) {
+        QImage* frame = pool.acquire( size );
+        QVERIFY( frame == first || frame == second );
+        const uchar* bits = frame->constBits();
+        QPainter painter( frame );
+        painter.fillRect( frame->rect(), Qt::green );
+        painter.end();
+        QCOMPARE( frame->constBits(), bits );
+        pool.present( frame );
+    }
+    QCOMPARE( pool.allocations(), 2 );
+}
+
+void FrameBufferPoolTest::resize()
+{
+    FrameBufferPool pool( 2 );
+    pool.acquire( QSize( 64, 32 ) );
+    QCOMPARE( pool.allocations(), 1 );
+
+    QImage* frame = pool.acquire( QSize( 32, 64 ) );
+    QCOMPARE( frame->size(), QSize( 32, 64 ) );
+    QCOMPARE( pool.allocations(), 2 );
+
+    pool.clear();
+    QCOMPARE( pool.acquire( QSize( 32, 64 ) )->size(), QSize( 32, 64 ) );
+    QCOMPARE( pool.allocations(), 3 );
+}
+
+void FrameBufferPoolTest::failedRender()
+{
+    FrameBufferPool pool( 2 );
+    const QSize size( 64, 32 );
+
+    QImage* shown = pool.acquire( size );
+    pool.present( shown );
+
+    // Renders that are thrown away never reach the buffer on screen.
+    QImage* next = pool.acquire( size );
+    QVERIFY( next != shown );
+    QCOMPARE( pool.acquire( size ), next );
+    QCOMPARE( pool.acquire( size ), next );
+
+    pool.present( next );
+    QCOMPARE( pool.acquire( size ), shown );
+}
+
+#include "framebufferpool_test.moc"
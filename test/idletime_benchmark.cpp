@@ -0,0 +1,129 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+   Counts the X requests each idle time backend sends for an hour of
+   RSITimer ticks, one getIdleTime() a second. Run it on an X server
+   with nothing else going on, e.g.
+
+       xvfb-run rsibreak_idletime_benchmark
+
+   The hour is simulated, the ticks follow each other without waiting,
+   as neither backend sends more or less depending on the time between
+   them. With xdotool installed the XSync backend is additionally taken
+   through a few idle and active cycles, which is all it asks the server
+   about.
+*/
+
+#include "rsiidletime.h"
+#include "rsiidletimexsync.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+#include <QX11Info>
+
+#include <X11/Xlib.h>
+
+static const int TICKS_PER_HOUR = 3600;
+static const int CYCLES = 5;
+static const int CYCLE_TIMEOUT_MS = 5000;
+
+// Sends the ticks of an hour, @returns the time they took in ms.
+static qint64 tickHour( const RSIIdleTime& idleTime )
+{
+    QElapsedTimer timer;
+    timer.start();
+    for ( int i = 0; i < TICKS_PER_HOUR; ++i )
+        idleTime.getIdleTime();
+    return timer.elapsed();
+}
+
+// Waits for the user to be idle or active. @returns false on timeout.
+static bool waitForIdle( const RSIIdleTime& idleTime, bool idle )
+{
+    QElapsedTimer timeout;
+    timeout.start();
+    while ( ( idleTime.getIdleTime() >= 1000 ) != idle ) {
+        if ( timeout.elapsed() > CYCLE_TIMEOUT_MS )
+            return false;
+        QThread::msleep( 10 );
+    }
+    return true;
+}
+
+int main( int argc, char *argv[] )
+{
+    QApplication app( argc, argv );
+    QTextStream out( stdout );
+
+    if ( QGuiApplication::platformName() != QLatin1String( "xcb" ) ) {
+        out << "This benchmark needs an X server" << endl;
+        return 1;
+    }
+
+    out << "X requests for " << TICKS_PER_HOUR << " ticks, one hour" << endl;
+    out << "backend     setup     ticks   time/ms" << endl;
+
+    // KIdleTime talks over the connection of Qt.
+    Display* display = QX11Info::display();
+    RSIIdleTimeImpl kidletime;
+    unsigned long first = XNextRequest( display );
+    kidletime.getIdleTime();
+    const unsigned long setup = XNextRequest( display ) - first;
+    first = XNextRequest( display );
+    qint64 elapsed = tickHour( kidletime );
+    out << qSetFieldWidth( 10 ) << left << "KIdleTime" << right << setup
+        << XNextRequest( display ) - first << elapsed << qSetFieldWidth( 0 ) << endl;
+
+    RSIIdleTimeXSync xsync;
+    if ( !xsync.start() ) {
+        out << "XSync      no IDLETIME counter" << endl;
+        return 1;
+    }
+    const quint64 xsyncSetup = xsync.requestCount();
+    elapsed = tickHour( xsync );
+    out << qSetFieldWidth( 10 ) << left << "XSync" << right << xsyncSetup
+        << xsync.requestCount() - xsyncSetup << elapsed << qSetFieldWidth( 0 ) << endl;
+
+    const QString xdotool = QStandardPaths::findExecutable( QStringLiteral( "xdotool" ) );
+    if ( xdotool.isEmpty() ) {
+        out << "Install xdotool to count the requests of idle and active cycles" << endl;
+        return 0;
+    }
+
+    // Each cycle is one alarm going idle and one going active again.
+    const quint64 before = xsync.requestCount();
+    for ( int i = 0; i < CYCLES; ++i ) {
+        if ( !waitForIdle( xsync, true ) ) {
+            out << "The user never became idle, is something sending input?" << endl;
+            return 1;
+        }
+        QProcess::execute( xdotool, QStringList() << QStringLiteral( "mousemove_relative" )
+                           << QStringLiteral( "1" ) << QStringLiteral( "1" ) );
+        if ( !waitForIdle( xsync, false ) ) {
+            out << "The input did not reach the server" << endl;
+            return 1;
+        }
+    }
+    out << "XSync, " << double( xsync.requestCount() - before ) / CYCLES
+        << " requests per idle and active cycle" << endl;
+
+    return 0;
+}
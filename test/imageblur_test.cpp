@@ -0,0 +1,93 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "imageblur_test.h"
+
+#include "imageblur.h"
+
+static QImage noise( const QSize& size )
+{
+    QImage image( size, QImage::Format_RGB32 );
+    quint32 seed = 7;
+    for ( int y = 0; y < size.height(); ++y ) {
+        QRgb* line = reinterpret_cast<QRgb*>( image.scanLine( y ) );
+        for ( int x = 0; x < size.width(); ++x ) {
+            seed = seed * 1103515245 + 12345;
+            line[x] = 0xff000000 | ( seed >> 8 );
+        }
+    }
+    return image;
+}
+
+void ImageBlurTest::solidColor()
+{
+    QImage image( 300, 200, QImage::Format_RGB32 );
+    image.fill( qRgb( 10, 200, 77 ) );
+
+    ImageBlur::blur( &image, 8 );
+    QCOMPARE( image.pixel( 0, 0 ), qRgb( 10, 200, 77 ) );
+    QCOMPARE( image.pixel( 150, 100 ), qRgb( 10, 200, 77 ) );
+    QCOMPARE( image.pixel( 299, 199 ), qRgb( 10, 200, 77 ) );
+}
+
+void ImageBlurTest::spreadsEdge()
+{
+    // Left half black, right half white: the edge becomes a ramp.
+    QImage image( 200, 50, QImage::Format_RGB32 );
+    image.fill( Qt::black );
+    for ( int y = 0; y < image.height(); ++y )
+        for ( int x = 100; x < image.width(); ++x )
+            image.setPixel( x, y, qRgb( 255, 255, 255 ) );
+
+    ImageBlur::blur( &image, 4 );
+    QCOMPARE( qRed( image.pixel( 0, 25 ) ), 0 );
+    QCOMPARE( qRed( image.pixel( 199, 25 ) ), 255 );
+    QVERIFY( qRed( image.pixel( 98, 25 ) ) > 0 );
+    QVERIFY( qRed( image.pixel( 101, 25 ) ) < 255 );
+    QVERIFY( qRed( image.pixel( 98, 25 ) ) < qRed( image.pixel( 101, 25 ) ) );
+}
+
+void ImageBlurTest::kernelsAgree()
+{
+    // Large enough to be split on the thread pool.
+    const QImage source = noise( QSize( 700, 500 ) );
+    QImage reference = source;
+    ImageBlur::blur( &reference, 5, ImageScaler::Scalar );
+
+    for ( int kernel = ImageScaler::SSE2; kernel <= ImageScaler::AVX2; ++kernel ) {
+        if ( !ImageScaler::isSupported( ImageScaler::Kernel( kernel ) ) )
+            continue;
+        QImage blurred = source;
+        ImageBlur::blur( &blurred, 5, ImageScaler::Kernel( kernel ) );
+        QCOMPARE( blurred, reference );
+    }
+}
+
+void ImageBlurTest::sharedImage()
+{
+    const QImage source = noise( QSize( 300, 200 ) );
+
+    // The same pixels, but not shared with the source.
+    QImage unshared = noise( source.size() );
+    ImageBlur::blur( &unshared, 5, ImageScaler::Scalar );
+
+    QImage shared = source;
+    ImageBlur::blur( &shared, 5, ImageScaler::Scalar );
+    QCOMPARE( shared, unshared );
+    QVERIFY( shared != source );
+}
+
+#include "imageblur_test.moc"
@@ -0,0 +1,89 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "imagebundle_test.h"
+
+#include "imagebundle.h"
+
+#include <QBuffer>
+#include <QTemporaryDir>
+
+static QByteArray encodePng( const QImage& image )
+{
+    QByteArray data;
+    QBuffer buffer( &data );
+    buffer.open( QIODevice::WriteOnly );
+    image.save( &buffer, "PNG" );
+    return data;
+}
+
+void ImageBundleTest::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString path = dir.path() + "/test.rsibundle";
+    QVERIFY( ImageBundle::isBundle( path ) );
+
+    QImage red( 32, 16, QImage::Format_RGB32 );
+    red.fill( Qt::red );
+    QImage blue( 8, 24, QImage::Format_RGB32 );
+    blue.fill( Qt::blue );
+
+    ImageBundleWriter writer;
+    QVERIFY( writer.open( path ) );
+    QVERIFY( writer.add( encodePng( red ), red.size() ) );
+    QVERIFY( writer.add( encodePng( blue ), blue.size() ) );
+    QVERIFY( writer.finish() );
+
+    ImageBundle bundle;
+    QVERIFY( bundle.open( path ) );
+    QCOMPARE( bundle.count(), 2 );
+    QCOMPARE( bundle.imageSize( 0 ), red.size() );
+    QCOMPARE( bundle.imageSize( 1 ), blue.size() );
+    QCOMPARE( bundle.imageSize( 2 ), QSize() );
+
+    const QImage first = bundle.image( 0 );
+    QCOMPARE( first.size(), red.size() );
+    QCOMPARE( first.pixel( 3, 3 ), red.pixel( 3, 3 ) );
+
+    const QImage second = bundle.image( 1 );
+    QCOMPARE( second.size(), blue.size() );
+    QCOMPARE( second.pixel( 3, 3 ), blue.pixel( 3, 3 ) );
+
+    QVERIFY( bundle.image( -1 ).isNull() );
+    bundle.close();
+    QVERIFY( !bundle.isOpen() );
+}
+
+void ImageBundleTest::rejectInvalid()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString path = dir.path() + "/broken.rsibundle";
+
+    QFile file( path );
+    QVERIFY( file.open( QIODevice::WriteOnly ) );
+    file.write( QByteArray( 64, 'x' ) );
+    file.close();
+
+    ImageBundle bundle;
+    QVERIFY( !bundle.open( path ) );
+    QVERIFY( !bundle.open( dir.path() + "/missing.rsibundle" ) );
+    QCOMPARE( bundle.count(), 0 );
+    QVERIFY( !ImageBundle::isBundle( dir.path() + "/image.png" ) );
+}
+
+#include "imagebundle_test.moc"
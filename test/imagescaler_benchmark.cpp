@@ -0,0 +1,113 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "imagescaler_benchmark.h"
+
+#include "imagescaler.h"
+
+#include <QPainter>
+
+Q_DECLARE_METATYPE( ImageScaler::Kernel )
+
+void ImageScalerBenchmark::initTestCase()
+{
+    // A typical camera picture, 24 megapixels.
+    m_source = QImage( 6000, 4000, QImage::Format_RGB32 );
+    QPainter painter( &m_source );
+    QLinearGradient gradient( 0, 0, m_source.width(), m_source.height() );
+    gradient.setColorAt( 0, Qt::darkBlue );
+    gradient.setColorAt( 1, Qt::yellow );
+    painter.fillRect( m_source.rect(), gradient );
+    for ( int x = 0; x < m_source.width(); x += 7 )
+        painter.drawLine( x, 0, m_source.width() - x, m_source.height() );
+}
+
+void ImageScalerBenchmark::screenSizes()
+{
+    QTest::addColumn<QSize>( "size" );
+    QTest::newRow( "1080p" ) << QSize( 1920, 1080 );
+    QTest::newRow( "1440p" ) << QSize( 2560, 1440 );
+    QTest::newRow( "4K" ) << QSize( 3840, 2160 );
+}
+
+void ImageScalerBenchmark::qtFast_data()
+{
+    screenSizes();
+}
+
+void ImageScalerBenchmark::qtFast()
+{
+    QFETCH( QSize, size );
+    QBENCHMARK {
+        m_source.scaled( size, Qt::KeepAspectRatio, Qt::FastTransformation );
+    }
+}
+
+void ImageScalerBenchmark::qtSmooth_data()
+{
+    screenSizes();
+}
+
+void ImageScalerBenchmark::qtSmooth()
+{
+    QFETCH( QSize, size );
+    QBENCHMARK {
+        m_source.scaled( size, Qt::KeepAspectRatio, Qt::SmoothTransformation );
+    }
+}
+
+void ImageScalerBenchmark::scaler_data()
+{
+    QTest::addColumn<QSize>( "size" );
+    QTest::addColumn<ImageScaler::Kernel>( "kernel" );
+
+    const QList<QPair<QByteArray, QSize> > sizes = QList<QPair<QByteArray, QSize> >()
+            << qMakePair( QByteArray( "1080p" ), QSize( 1920, 1080 ) )
+            << qMakePair( QByteArray( "1440p" ), QSize( 2560, 1440 ) )
+            << qMakePair( QByteArray( "4K" ), QSize( 3840, 2160 ) );
+    const QList<QPair<QByteArray, ImageScaler::Kernel> > kernels = QList<QPair<QByteArray, ImageScaler::Kernel> >()
+            << qMakePair( QByteArray( "scalar" ), ImageScaler::Scalar )
+            << qMakePair( QByteArray( "sse2" ), ImageScaler::SSE2 )
+            << qMakePair( QByteArray( "avx2" ), ImageScaler::AVX2 );
+
+    for ( int s = 0; s < sizes.count(); ++s ) {
+        for ( int k = 0; k < kernels.count(); ++k ) {
+            if ( !ImageScaler::isSupported( kernels[k].second ) )
+                continue;
+            const QByteArray name = sizes[s].first + ' ' + kernels[k].first;
+            QTest::newRow( name.constData() ) << sizes[s].second << kernels[k].second;
+        }
+    }
+}
+
+void ImageScalerBenchmark::scaler()
+{
+    QFETCH( QSize, size );
+    QFETCH( ImageScaler::Kernel, kernel );
+
+    // Same geometry as the slide show: fit into a reused screen buffer.
+    QImage frame( size, QImage::Format_RGB32 );
+    QRect target( QPoint( 0, 0 ), m_source.size().scaled( size, Qt::KeepAspectRatio ) );
+    target.moveCenter( frame.rect().center() );
+
+    QBENCHMARK {
+        ImageScaler::scale( m_source, &frame, target, kernel );
+    }
+}
+
+QTEST_GUILESS_MAIN( ImageScalerBenchmark )
+
+#include "imagescaler_benchmark.moc"
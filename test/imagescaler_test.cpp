@@ -0,0 +1,89 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "imagescaler_test.h"
+
+#include "imagescaler.h"
+
+static QImage noise( const QSize& size )
+{
+    QImage image( size, QImage::Format_RGB32 );
+    quint32 seed = 1;
+    for ( int y = 0; y < size.height(); ++y ) {
+        QRgb* line = reinterpret_cast<QRgb*>( image.scanLine( y ) );
+        for ( int x = 0; x < size.width(); ++x ) {
+            seed = seed * 1103515245 + 12345;
+            line[x] = 0xff000000 | ( seed >> 8 );
+        }
+    }
+    return image;
+}
+
+static int maxDifference( const QImage& a, const QImage& b )
+{
+    int result = 0;
+    for ( int y = 0; y < a.height(); ++y ) {
+        const uchar* la = a.constScanLine( y );
+        const uchar* lb = b.constScanLine( y );
+        for ( int i = 0; i < a.width() * 4; ++i )
+            result = qMax( result, qAbs( la[i] - lb[i] ) );
+    }
+    return result;
+}
+
+void ImageScalerTest::solidColor()
+{
+    QImage source( 1000, 700, QImage::Format_RGB32 );
+    source.fill( qRgb( 10, 200, 77 ) );
+
+    const QImage down = ImageScaler::scaled( source, QSize( 333, 211 ) );
+    QCOMPARE( down.size(), QSize( 333, 211 ) );
+    QCOMPARE( down.pixel( 0, 0 ), qRgb( 10, 200, 77 ) );
+    QCOMPARE( down.pixel( 332, 210 ), qRgb( 10, 200, 77 ) );
+    QCOMPARE( down.pixel( 100, 100 ), qRgb( 10, 200, 77 ) );
+
+    const QImage up = ImageScaler::scaled( source, QSize( 1500, 1100 ) );
+    QCOMPARE( up.pixel( 1499, 1099 ), qRgb( 10, 200, 77 ) );
+}
+
+void ImageScalerTest::kernelsAgree()
+{
+    // Large enough to be split in bands on the thread pool.
+    const QImage source = noise( QSize( 1600, 1200 ) );
+    const QImage reference = ImageScaler::scaled( source, QSize( 1021, 577 ), ImageScaler::Scalar );
+
+    for ( int kernel = ImageScaler::SSE2; kernel <= ImageScaler::AVX2; ++kernel ) {
+        if ( !ImageScaler::isSupported( ImageScaler::Kernel( kernel ) ) )
+            continue;
+        const QImage scaled = ImageScaler::scaled( source, reference.size(), ImageScaler::Kernel( kernel ) );
+        // Rounding of exact halves may differ by one.
+        QVERIFY( maxDifference( reference, scaled ) <= 1 );
+    }
+}
+
+void ImageScalerTest::cropToDestination()
+{
+    const QImage source = noise( QSize( 400, 300 ) );
+    const QImage full = ImageScaler::scaled( source, QSize( 200, 150 ), ImageScaler::Scalar );
+
+    // Only the visible half of an oversized target is written.
+    QImage dst( 100, 150, QImage::Format_RGB32 );
+    dst.fill( Qt::black );
+    ImageScaler::scale( source, &dst, QRect( -50, 0, 200, 150 ), ImageScaler::Scalar );
+    QCOMPARE( dst, full.copy( 50, 0, 100, 150 ) );
+}
+
+#include "imagescaler_test.moc"
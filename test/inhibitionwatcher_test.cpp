@@ -0,0 +1,114 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "inhibitionwatcher_test.h"
+
+#include "inhibitionwatcher.h"
+
+#include <QDBusMessage>
+#include <QSignalSpy>
+
+static const char* SERVICE_CONNECTION = "rsibreak-inhibitionwatcher-test";
+
+void MockNotifications::setInhibited( bool inhibited, QDBusConnection& connection )
+{
+    m_inhibited = inhibited;
+
+    QVariantMap changed;
+    changed.insert( "Inhibited", inhibited );
+    QDBusMessage signal = QDBusMessage::createSignal( "/org/freedesktop/Notifications",
+                                                      "org.freedesktop.DBus.Properties", "PropertiesChanged" );
+    signal << QString( "org.freedesktop.Notifications" ) << changed << QStringList();
+    connection.send( signal );
+}
+
+void InhibitionWatcherTest::initTestCase()
+{
+    m_service = nullptr;
+    if ( !QDBusConnection::sessionBus().isConnected() )
+        QSKIP( "No session bus" );
+
+    // The mocks live on their own connection, so signals go through the bus.
+    m_service = new QDBusConnection( QDBusConnection::connectToBus( QDBusConnection::SessionBus,
+                                                                    SERVICE_CONNECTION ) );
+    QVERIFY( m_service->isConnected() );
+    QVERIFY( m_service->registerObject( "/org/freedesktop/PowerManagement/Inhibit", &m_powerManagement,
+                                        QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals ) );
+    QVERIFY( m_service->registerObject( "/org/freedesktop/Notifications", &m_notifications,
+                                        QDBusConnection::ExportAllProperties ) );
+}
+
+void InhibitionWatcherTest::cleanupTestCase()
+{
+    if ( !m_service )
+        return;
+
+    m_service->unregisterObject( "/org/freedesktop/PowerManagement/Inhibit" );
+    m_service->unregisterObject( "/org/freedesktop/Notifications" );
+    delete m_service;
+    QDBusConnection::disconnectFromBus( SERVICE_CONNECTION );
+}
+
+void InhibitionWatcherTest::initialState()
+{
+    m_powerManagement.hasInhibit = true;
+    InhibitionWatcher watcher( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    QSignalSpy changed( &watcher, &InhibitionWatcher::inhibitedChanged );
+
+    // Asked asynchronously.
+    QVERIFY( !watcher.isInhibited() );
+    QVERIFY( changed.wait() );
+    QCOMPARE( watcher.reasons(), InhibitionWatcher::Reasons( InhibitionWatcher::ScreenSaverInhibited ) );
+    m_powerManagement.hasInhibit = false;
+}
+
+void InhibitionWatcherTest::followSignals()
+{
+    InhibitionWatcher watcher( QDBusConnection::sessionBus(), m_service->baseService(), m_service->baseService() );
+    QSignalSpy changed( &watcher, &InhibitionWatcher::inhibitedChanged );
+    // Let the first answers arrive.
+    QTest::qWait( 200 );
+    QVERIFY( !watcher.isInhibited() );
+
+    emit m_powerManagement.HasInhibitChanged( true );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), true );
+
+    // A second reason changes the reasons, not whether breaks wait.
+    m_notifications.setInhibited( true, *m_service );
+    QTRY_VERIFY( watcher.reasons() & InhibitionWatcher::NotificationsInhibited );
+    QCOMPARE( changed.count(), 0 );
+
+    emit m_powerManagement.HasInhibitChanged( false );
+    QTRY_COMPARE( watcher.reasons(), InhibitionWatcher::Reasons( InhibitionWatcher::NotificationsInhibited ) );
+    QCOMPARE( changed.count(), 0 );
+
+    m_notifications.setInhibited( false, *m_service );
+    QVERIFY( changed.wait() );
+    QCOMPARE( changed.takeFirst().at( 0 ).toBool(), false );
+}
+
+void InhibitionWatcherTest::missingServices()
+{
+    InhibitionWatcher watcher( QDBusConnection::sessionBus(), "org.rsibreak.NoSuchService",
+                               "org.rsibreak.NoSuchService" );
+    QSignalSpy changed( &watcher, &InhibitionWatcher::inhibitedChanged );
+
+    QVERIFY( !changed.wait( 500 ) );
+    QVERIFY( !watcher.isInhibited() );
+}
+
+#include "inhibitionwatcher_test.moc"
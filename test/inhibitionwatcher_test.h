@@ -0,0 +1,78 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef RSIBREAK_INHIBITIONWATCHER_TEST_H
+#define RSIBREAK_INHIBITIONWATCHER_TEST_H
+
+#include <QDBusConnection>
+#include <QtTest>
+
+class MockPowerManagement : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "D-Bus Interface", "org.freedesktop.PowerManagement.Inhibit" )
+
+public:
+    MockPowerManagement() : hasInhibit( false ) {}
+    bool hasInhibit;
+
+public slots:
+    bool HasInhibit() {
+        return hasInhibit;
+    }
+
+signals:
+    void HasInhibitChanged( bool hasInhibit );
+};
+
+class MockNotifications : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "D-Bus Interface", "org.freedesktop.Notifications" )
+    Q_PROPERTY( bool Inhibited READ inhibited )
+
+public:
+    MockNotifications() : m_inhibited( false ) {}
+
+    bool inhibited() const {
+        return m_inhibited;
+    }
+
+    // Changes the property and announces it on @p connection.
+    void setInhibited( bool inhibited, QDBusConnection& connection );
+
+private:
+    bool m_inhibited;
+};
+
+class InhibitionWatcherTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void initialState();
+    void followSignals();
+    void missingServices();
+
+private:
+    QDBusConnection* m_service;
+    MockPowerManagement m_powerManagement;
+    MockNotifications m_notifications;
+};
+
+#endif //RSIBREAK_INHIBITIONWATCHER_TEST_H
@@ -0,0 +1,54 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "progressicon_test.h"
+
+#include "progressicon.h"
+
+void ProgressIconTest::frameFor()
+{
+    QCOMPARE( ProgressIcon::frameFor( 0.0 ), 0 );
+    QCOMPARE( ProgressIcon::frameFor( 100.0 ), ProgressIcon::FRAME_COUNT - 1 );
+    QCOMPARE( ProgressIcon::frameFor( -3.0 ), 0 );
+    QCOMPARE( ProgressIcon::frameFor( 250.0 ), ProgressIcon::FRAME_COUNT - 1 );
+
+    // A second of a ten minute interval rarely moves to the next frame.
+    const double step = 100.0 / ( 10 * 60 );
+    int changes = 0;
+    for ( int s = 1; s <= 10 * 60; ++s ) {
+        if ( ProgressIcon::frameFor( s * step ) != ProgressIcon::frameFor( ( s - 1 ) * step ) )
+            ++changes;
+    }
+    QCOMPARE( changes, ProgressIcon::FRAME_COUNT - 1 );
+}
+
+void ProgressIconTest::framesAreCached()
+{
+    ProgressIcon icon;
+
+    const QIcon& first = icon.frame( 0 );
+    QVERIFY( !first.isNull() );
+    QVERIFY( first.availableSizes().contains( QSize( 22, 22 ) ) );
+    QCOMPARE( icon.frame( 0 ).cacheKey(), first.cacheKey() );
+
+    const QImage empty = icon.frame( 0 ).pixmap( 48, 48 ).toImage();
+    const QImage half = icon.frame( ProgressIcon::FRAME_COUNT / 2 ).pixmap( 48, 48 ).toImage();
+    QVERIFY( empty != half );
+
+    QVERIFY( !icon.suspended().isNull() );
+}
+
+#include "progressicon_test.moc"
@@ -0,0 +1,75 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiactivitywindow_test.h"
+
+#include "rsiactivitywindow.h"
+
+static constexpr int TEST_WINDOW = 60;
+static constexpr int TEST_BUDGET = 50;
+
+void RSIActivityWindowTest::reachBudget()
+{
+    RSIActivityWindow window( TEST_WINDOW, TEST_BUDGET );
+
+    // Idle gaps do not reset the window.
+    for ( int i = 0; i < TEST_WINDOW; ++i ) {
+        QCOMPARE( window.tick( true ), false );
+        QCOMPARE( window.tick( false ), false );
+    }
+    // Half of the ticks in the window are active, below the budget.
+    QCOMPARE( window.activeTicks(), TEST_WINDOW / 2 );
+
+    window.reset();
+    for ( int i = 0; i < TEST_BUDGET - 1; ++i )
+        QCOMPARE( window.tick( true ), false );
+    QCOMPARE( window.ticksLeft(), 1 );
+    QCOMPARE( window.tick( true ), true );
+
+    // Reported once until the budget is regained.
+    QCOMPARE( window.tick( true ), false );
+    QCOMPARE( window.ticksLeft(), 0 );
+}
+
+void RSIActivityWindowTest::slideOut()
+{
+    RSIActivityWindow window( TEST_WINDOW, TEST_BUDGET );
+
+    for ( int i = 0; i < TEST_BUDGET; ++i )
+        window.tick( true );
+    QCOMPARE( window.activeTicks(), TEST_BUDGET );
+
+    // The activity leaves the window one tick at a time.
+    for ( int i = 0; i < TEST_WINDOW - TEST_BUDGET; ++i )
+        window.tick( false );
+    QCOMPARE( window.activeTicks(), TEST_BUDGET );
+    window.tick( false );
+    QCOMPARE( window.activeTicks(), TEST_BUDGET - 1 );
+
+    // An active tick replacing an active one keeps the sum.
+    QCOMPARE( window.tick( true ), false );
+    QCOMPARE( window.activeTicks(), TEST_BUDGET - 1 );
+
+    // Once the window drained, reaching the budget is reported again.
+    for ( int i = 0; i < TEST_WINDOW; ++i )
+        window.tick( false );
+    QCOMPARE( window.activeTicks(), 0 );
+    for ( int i = 0; i < TEST_BUDGET - 1; ++i )
+        QCOMPARE( window.tick( true ), false );
+    QCOMPARE( window.tick( true ), true );
+}
+
+#include "rsiactivitywindow_test.moc"
@@ -0,0 +1,122 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiappusage_test.h"
+
+#include "rsiappusage.h"
+
+#include <QTemporaryDir>
+
+#include <KConfigGroup>
+
+void RSIAppUsageTest::countFocused()
+{
+    RSIAppUsage usage;
+
+    // Nothing is focused yet, the seconds go to nobody.
+    usage.tick();
+    QVERIFY( usage.top( 5 ).isEmpty() );
+
+    usage.setActive( "konsole" );
+    usage.tick();
+    usage.tick();
+    usage.setActive( "firefox" );
+    usage.tick();
+    usage.setActive( "konsole" );
+    usage.tick();
+
+    QCOMPARE( usage.seconds( "konsole" ), 3 );
+    QCOMPARE( usage.seconds( "firefox" ), 1 );
+    QCOMPARE( usage.seconds( "kate" ), 0 );
+    QCOMPARE( usage.seconds( QString() ), 0 );
+}
+
+void RSIAppUsageTest::topApplications()
+{
+    RSIAppUsage usage;
+    const QStringList applications = { "kate", "konsole", "firefox", "dolphin" };
+    for ( int i = 0; i < applications.size(); ++i ) {
+        usage.setActive( applications[i] );
+        for ( int s = 0; s <= i; ++s )
+            usage.tick();
+    }
+
+    const QVector<RSIAppUsage::Entry> top = usage.top( 2 );
+    QCOMPARE( top.size(), 2 );
+    QCOMPARE( top[0], RSIAppUsage::Entry( "dolphin", 4 ) );
+    QCOMPARE( top[1], RSIAppUsage::Entry( "firefox", 3 ) );
+
+    QCOMPARE( usage.top( 10 ).size(), applications.size() );
+    QVERIFY( usage.top( 0 ).isEmpty() );
+}
+
+void RSIAppUsageTest::capacity()
+{
+    RSIAppUsage usage;
+    for ( int i = 0; i < RSIAppUsage::CAPACITY; ++i ) {
+        usage.setActive( QString( "app%1" ).arg( i ) );
+        usage.tick();
+    }
+
+    // No room left, the time is not attributed.
+    usage.setActive( "onetoomany" );
+    usage.tick();
+    QCOMPARE( usage.seconds( "onetoomany" ), 0 );
+    QCOMPARE( usage.top( RSIAppUsage::CAPACITY + 1 ).size(), RSIAppUsage::CAPACITY );
+
+    // Those known keep counting.
+    usage.setActive( "app7" );
+    usage.tick();
+    QCOMPARE( usage.seconds( "app7" ), 2 );
+}
+
+void RSIAppUsageTest::storage()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString path = dir.filePath( "rsibreakusagerc" );
+    const QString today = QDate::currentDate().toString( Qt::ISODate );
+
+    // An outdated day is dropped on the next save.
+    {
+        KSharedConfig::Ptr state = KSharedConfig::openConfig( path, KConfig::SimpleConfig );
+        const QString old = QDate::currentDate().addDays( -RSIAppUsage::KEEP_DAYS ).toString( Qt::ISODate );
+        state->group( "AppUsage" ).group( old ).writeEntry( "kate", 10 );
+        state->sync();
+    }
+
+    {
+        RSIAppUsage usage;
+        usage.setStorage( KSharedConfig::openConfig( path, KConfig::SimpleConfig ) );
+        usage.setActive( "konsole" );
+        usage.tick();
+        usage.tick();
+    }
+
+    // The next run carries on with today's totals.
+    KSharedConfig::Ptr state = KSharedConfig::openConfig( path, KConfig::SimpleConfig );
+    state->reparseConfiguration();
+    QCOMPARE( state->group( "AppUsage" ).groupList(), QStringList( today ) );
+    QCOMPARE( state->group( "AppUsage" ).group( today ).readEntry( "konsole", 0 ), 2 );
+
+    RSIAppUsage usage;
+    usage.setStorage( state );
+    usage.setActive( "konsole" );
+    usage.tick();
+    QCOMPARE( usage.seconds( "konsole" ), 3 );
+}
+
+#include "rsiappusage_test.moc"
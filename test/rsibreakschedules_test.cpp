@@ -0,0 +1,125 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsibreakschedules_test.h"
+
+#include "rsibreakschedules.h"
+
+void RSIBreakSchedulesTest::mergeDueBreaks()
+{
+    RSIBreakSchedules schedules;
+    const int eyes = schedules.add( RSIBreakSchedules::ShortBreak, 0, 20, 20, 10 );
+    const int tiny = schedules.add( RSIBreakSchedules::ShortBreak, 1, 40, 30, 10 );
+    const int big = schedules.add( RSIBreakSchedules::LongBreak, 2, 120, 60, 60 );
+
+    for ( int i = 0; i < 19; ++i )
+        QCOMPARE( schedules.tick( 0 ).schedule, -1 );
+    QCOMPARE( schedules.tick( 0 ).schedule, eyes );
+    QVERIFY( schedules.isReset( eyes ) );
+
+    // At 40 both short schedules are due, the higher priority wins.
+    for ( int i = 0; i < 19; ++i )
+        QCOMPARE( schedules.tick( 0 ).schedule, -1 );
+    RSIBreakSchedules::Due due = schedules.tick( 0 );
+    QCOMPARE( due.schedule, tiny );
+    QCOMPARE( due.breakLength, 30 );
+    QVERIFY( schedules.isReset( eyes ) );
+
+    // At 120 all are due, the merged break is as long as the longest.
+    for ( int i = 0; i < 79; ++i )
+        schedules.tick( 0 );
+    due = schedules.tick( 0 );
+    QCOMPARE( due.schedule, big );
+    QCOMPARE( due.breakLength, 60 );
+    QCOMPARE( schedules.counterLeft( tiny ), 40 );
+}
+
+void RSIBreakSchedulesTest::idleReset()
+{
+    RSIBreakSchedules schedules;
+    const int tiny = schedules.add( RSIBreakSchedules::ShortBreak, 0, 100, 20, 10 );
+    const int big = schedules.add( RSIBreakSchedules::LongBreak, 1, 300, 60, 60 );
+
+    for ( int i = 0; i < 50; ++i )
+        schedules.tick( 0 );
+
+    quint32 idleReset = 0;
+    for ( int i = 1; i <= 10; ++i )
+        idleReset |= schedules.tick( i ).idleReset;
+    QCOMPARE( idleReset, 1u << tiny );
+    QVERIFY( schedules.isReset( tiny ) );
+    QVERIFY( !schedules.isReset( big ) );
+
+    // Staying idle does not count as skipping again.
+    QCOMPARE( schedules.tick( 11 ).idleReset, 0u );
+}
+
+void RSIBreakSchedulesTest::nextBreak()
+{
+    RSIBreakSchedules schedules;
+    const int tiny = schedules.add( RSIBreakSchedules::ShortBreak, 0, 100, 20, 10 );
+    const int big = schedules.add( RSIBreakSchedules::LongBreak, 1, 300, 60, 60 );
+
+    QCOMPARE( schedules.next(), tiny );
+
+    schedules.postpone( big, 100 );
+    QCOMPARE( schedules.next(), big );
+
+    schedules.postpone( big, 180 );
+    QCOMPARE( schedules.next(), tiny );
+}
+
+void RSIBreakSchedulesTest::weightedTicks()
+{
+    RSIBreakSchedules schedules;
+    const int tiny = schedules.add( RSIBreakSchedules::ShortBreak, 0, 100, 20, 10 );
+
+    // Active ticks count as much as their weight.
+    for ( int i = 0; i < 10; ++i )
+        schedules.tick( 0, 2 );
+    QCOMPARE( schedules.counterLeft( tiny ), 80 );
+
+    // Idle ticks count as one, whatever the weight.
+    for ( int i = 1; i <= 5; ++i )
+        schedules.tick( i, 2 );
+    QCOMPARE( schedules.counterLeft( tiny ), 75 );
+
+    for ( int i = 0; i < 37; ++i )
+        QCOMPARE( schedules.tick( 0, 2 ).schedule, -1 );
+    QCOMPARE( schedules.tick( 0, 2 ).schedule, tiny );
+}
+
+void RSIBreakSchedulesTest::postponeMerged()
+{
+    RSIBreakSchedules schedules;
+    const int tiny = schedules.add( RSIBreakSchedules::ShortBreak, 0, 60, 20, 30 );
+    const int big = schedules.add( RSIBreakSchedules::LongBreak, 1, 120, 60, 60 );
+
+    for ( int i = 0; i < 119; ++i )
+        schedules.tick( 0 );
+    RSIBreakSchedules::Due due = schedules.tick( 0 );
+    QCOMPARE( due.schedule, big );
+    QCOMPARE( due.dueMask, ( 1u << tiny ) | ( 1u << big ) );
+
+    // Both breaks come back together, none is dropped.
+    schedules.postponeAll( due.dueMask, 1 );
+    due = schedules.tick( 0 );
+    QCOMPARE( due.schedule, big );
+    QCOMPARE( due.dueMask, ( 1u << tiny ) | ( 1u << big ) );
+    QCOMPARE( due.breakLength, 60 );
+}
+
+#include "rsibreakschedules_test.moc"
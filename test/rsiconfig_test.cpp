@@ -0,0 +1,108 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiconfig_test.h"
+
+#include "rsiconfig.h"
+#include "rsiglobals.h"
+
+#include <QTemporaryFile>
+
+#include <KConfig>
+#include <KConfigGroup>
+
+void RSIConfigTest::defaults()
+{
+    QTemporaryFile file;
+    QVERIFY( file.open() );
+    KConfig empty( file.fileName(), KConfig::SimpleConfig );
+
+    const RSIConfig config = RSIConfig::read( empty );
+    QCOMPARE( config.diff( RSIConfig() ), RSIConfig::Changes( RSIConfig::NoChange ) );
+    QCOMPARE( config.intervals[TINY_BREAK_INTERVAL], 10 * 60 );
+    QCOMPARE( config.intervals[BIG_BREAK_DURATION], 60 );
+    QVERIFY( config.useIdleTimers );
+}
+
+void RSIConfigTest::readEntries()
+{
+    QTemporaryFile file;
+    QVERIFY( file.open() );
+    KConfig kconfig( file.fileName(), KConfig::SimpleConfig );
+    KConfigGroup general = kconfig.group( "General Settings" );
+    general.writeEntry( "TinyInterval", 5 );
+    general.writeEntry( "BigDuration", 3 );
+    general.writeEntry( "UseNoIdleTimer", true );
+    general.writeEntry( "Effect", 2 );
+    general.writeEntry( "ImageFolder", "/tmp/images" );
+    kconfig.group( "Popup Settings" ).writeEntry( "UseFlash", false );
+
+    const RSIConfig config = RSIConfig::read( kconfig );
+    QCOMPARE( config.intervals[TINY_BREAK_INTERVAL], 5 * 60 );
+    QCOMPARE( config.intervals[BIG_BREAK_DURATION], 3 * 60 );
+    QVERIFY( !config.useIdleTimers );
+    QVERIFY( !config.useFlash );
+    QCOMPARE( config.effect, 2 );
+    QCOMPARE( config.imageFolder, QString( "/tmp/images" ) );
+
+    // Debug mode turns minutes into seconds.
+    general.writeEntry( "DEBUG", 1 );
+    QCOMPARE( RSIConfig::read( kconfig ).intervals[TINY_BREAK_INTERVAL], 5 );
+}
+
+void RSIConfigTest::diff()
+{
+    const RSIConfig base;
+
+    RSIConfig other = base;
+    other.intervals[PATIENCE_INTERVAL] = 10;
+    QCOMPARE( other.diff( base ), RSIConfig::Changes( RSIConfig::TimerChanged ) );
+
+    other = base;
+    other.hideLockButton = true;
+    QCOMPARE( other.diff( base ), RSIConfig::Changes( RSIConfig::ButtonsChanged ) );
+
+    // A gray level change must not recreate the effect, and a slide show
+    // setting must not touch the timer.
+    other = base;
+    other.grayLevel = 20;
+    QCOMPARE( other.diff( base ), RSIConfig::Changes( RSIConfig::GrayLevelChanged ) );
+
+    other = base;
+    other.slideInterval = 30;
+    other.useFlash = false;
+    QCOMPARE( other.diff( base ), RSIConfig::RelaxPopupChanged | RSIConfig::EffectChanged );
+}
+
+void RSIConfigTest::publishSnapshot()
+{
+    RSIGlobals* glbl = RSIGlobals::instance();
+    const std::shared_ptr<const RSIConfig> old = glbl->config();
+    const quint64 version = glbl->configVersion();
+
+    RSIConfig changed = *old;
+    changed.intervals[TINY_BREAK_DURATION] += 5;
+    glbl->setConfig( changed );
+
+    // Readers holding the old snapshot keep a consistent view.
+    QCOMPARE( glbl->configVersion(), version + 1 );
+    QCOMPARE( old->diff( *glbl->config() ), RSIConfig::Changes( RSIConfig::TimerChanged ) );
+    QCOMPARE( glbl->intervals()[TINY_BREAK_DURATION], old->intervals[TINY_BREAK_DURATION] + 5 );
+
+    glbl->setConfig( *old );
+}
+
+#include "rsiconfig_test.moc"
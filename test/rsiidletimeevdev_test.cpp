@@ -0,0 +1,140 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimeevdev_test.h"
+
+#ifdef HAVE_EVDEV
+#include "rsiidletimeevdev.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace
+{
+
+// A virtual device with one button which no desktop acts on.
+int createDevice( const char* name )
+{
+    const int fd = open( "/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC );
+    if ( fd < 0 )
+        return -1;
+
+    uinput_setup setup;
+    memset( &setup, 0, sizeof( setup ) );
+    setup.id.bustype = BUS_VIRTUAL;
+    strncpy( setup.name, name, UINPUT_MAX_NAME_SIZE - 1 );
+    if ( ioctl( fd, UI_SET_EVBIT, EV_KEY ) < 0 || ioctl( fd, UI_SET_KEYBIT, BTN_0 ) < 0 ||
+            ioctl( fd, UI_DEV_SETUP, &setup ) < 0 || ioctl( fd, UI_DEV_CREATE ) < 0 ) {
+        close( fd );
+        return -1;
+    }
+    return fd;
+}
+
+// Links the event node of the device into @p directory, so the backend
+// sees none of the real devices.
+bool linkDevice( int fd, const QString& directory )
+{
+    char sysname[64];
+    if ( ioctl( fd, UI_GET_SYSNAME( sizeof( sysname ) ), sysname ) < 0 )
+        return false;
+
+    const QDir sys( QStringLiteral( "/sys/class/input/" ) + QString::fromLatin1( sysname ) );
+    const QStringList nodes = sys.entryList( QStringList() << QStringLiteral( "event*" ), QDir::Dirs );
+    if ( nodes.isEmpty() )
+        return false;
+    return QFile::link( QStringLiteral( "/dev/input/" ) + nodes.first(), directory + '/' + nodes.first() );
+}
+
+void destroyDevice( int fd )
+{
+    ioctl( fd, UI_DEV_DESTROY );
+    close( fd );
+}
+
+bool emitEvent( int fd, int type, int code, int value )
+{
+    input_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return write( fd, &ev, sizeof( ev ) ) == sizeof( ev );
+}
+
+bool press( int fd )
+{
+    return emitEvent( fd, EV_KEY, BTN_0, 1 ) && emitEvent( fd, EV_SYN, SYN_REPORT, 0 ) &&
+           emitEvent( fd, EV_KEY, BTN_0, 0 ) && emitEvent( fd, EV_SYN, SYN_REPORT, 0 );
+}
+
+}
+#endif
+
+// Needs write access to /dev/uinput and read access to the devices it makes.
+void RSIIdleTimeEvdevTest::inputAndHotplug()
+{
+#ifndef HAVE_EVDEV
+    QSKIP( "evdev is only available on Linux" );
+#else
+    QTemporaryDir directory;
+    QVERIFY( directory.isValid() );
+
+    const int first = createDevice( "rsibreak test device" );
+    if ( first < 0 )
+        QSKIP( "Cannot create uinput devices" );
+    // Give udev time to set the permissions.
+    QTest::qWait( 500 );
+    if ( !linkDevice( first, directory.path() ) ) {
+        destroyDevice( first );
+        QSKIP( "Cannot find the event node of the uinput device" );
+    }
+
+    RSIIdleTimeEvdev idleTime( directory.path() );
+    if ( !idleTime.start() ) {
+        destroyDevice( first );
+        QSKIP( "Cannot read the input devices" );
+    }
+
+    QTRY_VERIFY( idleTime.getIdleTime() >= 300 );
+    QVERIFY( press( first ) );
+    QTRY_VERIFY( idleTime.getIdleTime() < 300 );
+
+    // Plugged in after the start.
+    const int second = createDevice( "rsibreak hotplug device" );
+    QVERIFY( second >= 0 );
+    QTest::qWait( 500 );
+    QVERIFY( linkDevice( second, directory.path() ) );
+    QTRY_VERIFY( idleTime.getIdleTime() >= 300 );
+    QVERIFY( press( second ) );
+    QTRY_VERIFY( idleTime.getIdleTime() < 300 );
+
+    // Unplugging is no input.
+    destroyDevice( second );
+    destroyDevice( first );
+    QTest::qWait( 500 );
+    QVERIFY( idleTime.getIdleTime() >= 400 );
+#endif
+}
+
+#include "rsiidletimeevdev_test.moc"
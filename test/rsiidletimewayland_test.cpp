@@ -0,0 +1,73 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimewayland_test.h"
+
+#ifdef HAVE_WAYLAND_IDLE_NOTIFY
+#include "rsiidletimewayland.h"
+#endif
+
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+// Runs against a headless weston of its own when weston is installed.
+void RSIIdleTimeWaylandTest::idleNotification()
+{
+#ifndef HAVE_WAYLAND_IDLE_NOTIFY
+    QSKIP( "Built without ext-idle-notify-v1" );
+#else
+    const QString weston = QStandardPaths::findExecutable( QStringLiteral( "weston" ) );
+    if ( weston.isEmpty() )
+        QSKIP( "weston is needed as compositor" );
+
+    QTemporaryDir runtimeDir;
+    QVERIFY( runtimeDir.isValid() );
+    const QString socket = runtimeDir.path() + QStringLiteral( "/wayland-rsibreak" );
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert( QStringLiteral( "XDG_RUNTIME_DIR" ), runtimeDir.path() );
+    QProcess compositor;
+    compositor.setProcessEnvironment( env );
+    compositor.start( weston, QStringList() << QStringLiteral( "--backend=headless" )
+                      << QStringLiteral( "--socket=wayland-rsibreak" ) );
+    QVERIFY( compositor.waitForStarted() );
+    QTRY_VERIFY_WITH_TIMEOUT( QFile::exists( socket ), 5000 );
+
+    const QByteArray oldDisplay = qgetenv( "WAYLAND_DISPLAY" );
+    qputenv( "WAYLAND_DISPLAY", socket.toLocal8Bit() );
+    RSIIdleTimeWayland idleTime;
+    const bool started = idleTime.start();
+    qputenv( "WAYLAND_DISPLAY", oldDisplay );
+
+    if ( started ) {
+        // Nothing sends input to a headless compositor.
+        QCOMPARE( idleTime.getIdleTime(), 0 );
+        QTRY_VERIFY_WITH_TIMEOUT( idleTime.getIdleTime() >= 1000, 5000 );
+        const int idle = idleTime.getIdleTime();
+        QTest::qWait( 500 );
+        QVERIFY( idleTime.getIdleTime() >= idle + 400 );
+    }
+
+    compositor.terminate();
+    compositor.waitForFinished();
+    if ( !started )
+        QSKIP( "The compositor has no seat or no ext-idle-notify-v1" );
+#endif
+}
+
+#include "rsiidletimewayland_test.moc"
@@ -0,0 +1,53 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiidletimexsync_test.h"
+
+#ifdef HAVE_XSYNC
+#include "rsiidletimexsync.h"
+#endif
+
+#include <QProcess>
+#include <QStandardPaths>
+
+// Run under Xvfb with xdotool installed, e.g. xvfb-run rsibreak_tests.
+void RSIIdleTimeXSyncTest::idleAndActive()
+{
+#ifndef HAVE_XSYNC
+    QSKIP( "Built without XSync" );
+#else
+    const QString xdotool = QStandardPaths::findExecutable( QStringLiteral( "xdotool" ) );
+    if ( xdotool.isEmpty() )
+        QSKIP( "xdotool is needed to send input" );
+
+    RSIIdleTimeXSync idleTime;
+    if ( !idleTime.start() )
+        QSKIP( "No X server with an IDLETIME counter" );
+
+    // Counted locally from the alarm on, without asking the server.
+    QTRY_VERIFY_WITH_TIMEOUT( idleTime.getIdleTime() >= 1000, 5000 );
+    const quint64 requests = idleTime.requestCount();
+    QTest::qWait( 500 );
+    QVERIFY( idleTime.getIdleTime() >= 1500 );
+    QCOMPARE( idleTime.requestCount(), requests );
+
+    QCOMPARE( QProcess::execute( xdotool, QStringList() << QStringLiteral( "mousemove_relative" )
+                                 << QStringLiteral( "1" ) << QStringLiteral( "1" ) ), 0 );
+    QTRY_COMPARE( idleTime.getIdleTime(), 0 );
+#endif
+}
+
+#include "rsiidletimexsync_test.moc"
@@ -0,0 +1,95 @@
+/*
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "rsiinputactivity_test.h"
+
+#include "rsiinputactivity.h"
+
+#include <QProcess>
+#include <QStandardPaths>
+
+void RSIInputActivityTest::takeCounters()
+{
+    RSIInputActivity activity;
+    activity.addKeys( 3 );
+    activity.addKeys( 2 );
+    activity.addClicks( 1 );
+    activity.addTravel( 250 );
+
+    RSIInputActivity::Sample sample = activity.take();
+    QCOMPARE( sample.keys, 5u );
+    QCOMPARE( sample.clicks, 1u );
+    QCOMPARE( sample.travel, 250u );
+
+    // Taken once only.
+    sample = activity.take();
+    QCOMPARE( sample.keys, 0u );
+    QCOMPARE( sample.clicks, 0u );
+    QCOMPARE( sample.travel, 0u );
+}
+
+void RSIInputActivityTest::lastMinute()
+{
+    RSIInputActivity activity;
+    for ( int i = 0; i < 60; ++i ) {
+        activity.addKeys( 4 );
+        activity.take();
+    }
+    QCOMPARE( activity.keysPerMinute(), 240 );
+    QVERIFY( !activity.isIntense() );
+
+    activity.addKeys( 5 );
+    activity.addClicks( 60 );
+    activity.take();
+    QCOMPARE( activity.keysPerMinute(), 241 );
+    QCOMPARE( activity.clicksPerMinute(), 60 );
+    QVERIFY( activity.isIntense() );
+
+    // Without input the minute drains one sample at a time.
+    for ( int i = 0; i < 59; ++i )
+        activity.take();
+    QCOMPARE( activity.keysPerMinute(), 5 );
+    activity.take();
+    QCOMPARE( activity.keysPerMinute(), 0 );
+    QCOMPARE( activity.clicksPerMinute(), 0 );
+}
+
+// Run under Xvfb to see raw events arrive, e.g. xvfb-run rsibreak_tests.
+void RSIInputActivityTest::rawEvents()
+{
+#ifndef HAVE_XINPUT2
+    QSKIP( "Built without XInput2" );
+#else
+    const QString xdotool = QStandardPaths::findExecutable( QStringLiteral( "xdotool" ) );
+    if ( xdotool.isEmpty() )
+        QSKIP( "xdotool is needed to send input" );
+
+    std::unique_ptr<RSIInputActivity> activity = RSIInputActivity::create();
+    if ( !activity )
+        QSKIP( "No X server with XInput 2.1" );
+
+    QCOMPARE( QProcess::execute( xdotool, QStringList() << QStringLiteral( "key" )
+                                 << QStringLiteral( "a" ) << QStringLiteral( "b" ) << QStringLiteral( "c" ) ), 0 );
+
+    // The events come in on the backend thread, sum up what has arrived.
+    RSIInputActivity::Sample total = { 0, 0, 0 };
+    QTRY_VERIFY( ( total.keys += activity->take().keys ) >= 3 );
+    QCOMPARE( QProcess::execute( xdotool, QStringList() << QStringLiteral( "click" ) << QStringLiteral( "1" ) ), 0 );
+    QTRY_VERIFY( ( total.clicks += activity->take().clicks ) >= 1 );
+#endif
+}
+
+#include "rsiinputactivity_test.moc"
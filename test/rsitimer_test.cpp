@@ -250,7 +250,7 @@ void RSITimerTest::screenLock()
     QList<QVariant> spyRelaxSignals = spyRelax.takeFirst();
     QCOMPARE( spyRelaxSignals.at( 0 ).toInt(), RELAX_ENDED_MAGIC_VALUE );
     QCOMPARE( spyMinimize.count(), 1 );
-    QVERIFY2( timer.m_bigBreakCounter->counterLeft() < m_intervals[BIG_BREAK_INTERVAL],
+    QVERIFY2( timer.bigLeft() < m_intervals[BIG_BREAK_INTERVAL],
               "Big break counter was reset on screen lock when it should have not." );
 }
 
@@ -276,7 +276,7 @@ void RSITimerTest::skipBreak()
     QList<QVariant> spyRelaxSignals = spyRelax.takeFirst();
     QCOMPARE( spyRelaxSignals.at( 0 ).toInt(), RELAX_ENDED_MAGIC_VALUE );
     QCOMPARE( spyMinimize.count(), 1 );
-    QVERIFY2( timer.m_bigBreakCounter->counterLeft() < m_intervals[BIG_BREAK_INTERVAL],
+    QVERIFY2( timer.bigLeft() < m_intervals[BIG_BREAK_INTERVAL],
               "Big break counter was reset on skip break when it should have not." );
 }
 
@@ -385,4 +385,204 @@ void RSITimerTest::regularBreaks()
     QCOMPARE( spyEndLongBreak.count(), 1 );
 }
 
+void RSITimerTest::activityBudget()
+{
+    QVector<int> intervals = m_intervals;
+    intervals[ACTIVITY_WINDOW] = 30 * 60;
+    intervals[ACTIVITY_BUDGET] = 10 * 60;
+
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), intervals, true, true );
+
+    QSignalSpy spyRelax( &timer, SIGNAL(relax(int,bool)) );
+    QSignalSpy spyEndLongBreak( &timer, SIGNAL(endLongBreak()) );
+
+    // Pauses long enough to skip every tiny break, but not the budget.
+    int active = 0;
+    for ( int tick = 0; tick < intervals[ACTIVITY_WINDOW]; tick++ ) {
+        if ( timer.m_state != RSITimer::TimerState::Monitoring )
+            break;
+        const int second = tick % 100;
+        if ( second < 39 ) {
+            idle_time_ptr->setIdleTime( 0 );
+            active++;
+        } else {
+            idle_time_ptr->setIdleTime( ( second - 38 ) * 1000 );
+        }
+        timer.timeout();
+    }
+
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( active, intervals[ACTIVITY_BUDGET] );
+    QCOMPARE( spyRelax.count(), 1 );
+    QCOMPARE( spyRelax.takeFirst().at( 0 ).toInt(), intervals[BIG_BREAK_DURATION] );
+
+    for ( int i = 0; i < intervals[BIG_BREAK_DURATION]; i++ ) {
+        idle_time_ptr->setIdleTime( ( i + 1 ) * 1000 );
+        timer.timeout();
+    }
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    QCOMPARE( spyEndLongBreak.count(), 1 );
+}
+
+void RSITimerTest::budgetDuringBreak()
+{
+    QVector<int> intervals = m_intervals;
+    intervals[ACTIVITY_WINDOW] = 30 * 60;
+    intervals[ACTIVITY_BUDGET] = intervals[TINY_BREAK_INTERVAL] + 10;
+
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), intervals, true, true );
+
+    QSignalSpy spyRelax( &timer, SIGNAL(relax(int,bool)) );
+
+    idle_time_ptr->setIdleTime( 0 );
+    for ( int i = 0; i < intervals[TINY_BREAK_INTERVAL]; i++ )
+        timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( spyRelax.takeFirst().at( 0 ).toInt(), intervals[TINY_BREAK_DURATION] );
+
+    // The budget runs out while the tiny break is suggested.
+    for ( int i = 0; i < 10; i++ )
+        timer.timeout();
+    for ( int i = 0; i < intervals[TINY_BREAK_DURATION]; i++ ) {
+        idle_time_ptr->setIdleTime( ( i + 1 ) * 1000 );
+        timer.timeout();
+    }
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+
+    // The tiny break does not answer it, a long one follows.
+    idle_time_ptr->setIdleTime( 0 );
+    timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( spyRelax.takeFirst().at( 0 ).toInt(), intervals[BIG_BREAK_DURATION] );
+}
+
+void RSITimerTest::inhibitedBreak()
+{
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), m_intervals, true, true );
+
+    QSignalSpy spyRelax( &timer, SIGNAL(relax(int,bool)) );
+
+    // A presentation runs past the tiny break.
+    timer.slotInhibited( true );
+    idle_time_ptr->setIdleTime( 0 );
+    for ( int i = 0; i < m_intervals[TINY_BREAK_INTERVAL] + 60; i++ ) {
+        timer.timeout();
+        QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    }
+    QCOMPARE( spyRelax.count(), 0 );
+    QCOMPARE( timer.tinyLeft(), 1 );
+
+    // The deferred break follows right after it.
+    timer.slotInhibited( false );
+    timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( spyRelax.count(), 1 );
+    QCOMPARE( spyRelax.takeFirst().at( 0 ).toInt(), m_intervals[TINY_BREAK_DURATION] );
+}
+
+void RSITimerTest::inhibitedBudget()
+{
+    QVector<int> intervals = m_intervals;
+    intervals[ACTIVITY_WINDOW] = 30 * 60;
+    intervals[ACTIVITY_BUDGET] = 5 * 60;
+
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), intervals, true, true );
+
+    QSignalSpy spyRelax( &timer, SIGNAL(relax(int,bool)) );
+
+    // The budget runs out during a presentation.
+    timer.slotInhibited( true );
+    idle_time_ptr->setIdleTime( 0 );
+    for ( int i = 0; i < intervals[ACTIVITY_BUDGET] + 60; i++ ) {
+        timer.timeout();
+        QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    }
+    QCOMPARE( spyRelax.count(), 0 );
+
+    // The long break is still owed afterwards.
+    timer.slotInhibited( false );
+    timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    QCOMPARE( spyRelax.count(), 1 );
+    QCOMPARE( spyRelax.takeFirst().at( 0 ).toInt(), intervals[BIG_BREAK_DURATION] );
+}
+
+void RSITimerTest::idleInhibitedBreak()
+{
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), m_intervals, true, true );
+
+    QSignalSpy spyRelax( &timer, SIGNAL(relax(int,bool)) );
+
+    // The tiny break falls due during a movie.
+    timer.slotInhibited( true );
+    idle_time_ptr->setIdleTime( 0 );
+    for ( int i = 0; i < m_intervals[TINY_BREAK_INTERVAL]; i++ )
+        timer.timeout();
+    QCOMPARE( timer.tinyLeft(), 1 );
+
+    // Watching without input for long enough counts as the break.
+    for ( int i = 1; i <= m_intervals[TINY_BREAK_THRESHOLD]; i++ ) {
+        idle_time_ptr->setIdleTime( i * 1000 );
+        timer.timeout();
+    }
+    QCOMPARE( timer.tinyLeft(), m_intervals[TINY_BREAK_INTERVAL] );
+
+    timer.slotInhibited( false );
+    idle_time_ptr->setIdleTime( 0 );
+    timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    QCOMPARE( spyRelax.count(), 0 );
+}
+
+void RSITimerTest::lockedCredit()
+{
+    std::unique_ptr<RSIIdleTimeFake> idle_time( new RSIIdleTimeFake() );
+    RSIIdleTimeFake* idle_time_ptr = idle_time.get();
+    RSITimer timer( std::move( idle_time ), m_intervals, true, true );
+
+    idle_time_ptr->setIdleTime( 0 );
+    for ( int i = 0; i < 10; i++ )
+        timer.timeout();
+    QCOMPARE( timer.tinyLeft(), m_intervals[TINY_BREAK_INTERVAL] - 10 );
+
+    // Nothing is counted while the screen stays locked.
+    timer.slotScreenLocked( true );
+    for ( int i = 0; i < 10; i++ )
+        timer.timeout();
+    QCOMPARE( timer.tinyLeft(), m_intervals[TINY_BREAK_INTERVAL] - 10 );
+
+    // A lock shorter than the tiny threshold earns nothing.
+    timer.m_lockedSince = QDateTime::currentDateTime().addSecs( -( m_intervals[TINY_BREAK_THRESHOLD] - 1 ) );
+    timer.slotScreenLocked( false );
+    QCOMPARE( timer.tinyLeft(), m_intervals[TINY_BREAK_INTERVAL] - 10 );
+    QCOMPARE( timer.bigLeft(), m_intervals[BIG_BREAK_INTERVAL] - 10 );
+
+    // A long one stands for both breaks.
+    timer.slotScreenLocked( true );
+    timer.m_lockedSince = QDateTime::currentDateTime().addSecs( -m_intervals[BIG_BREAK_THRESHOLD] );
+    timer.slotScreenLocked( false );
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+    QCOMPARE( timer.tinyLeft(), m_intervals[TINY_BREAK_INTERVAL] );
+    QCOMPARE( timer.bigLeft(), m_intervals[BIG_BREAK_INTERVAL] );
+
+    // A break suggested before the lock is over once the lock outlasts it.
+    for ( int i = 0; i < m_intervals[TINY_BREAK_INTERVAL]; i++ )
+        timer.timeout();
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Suggesting );
+    timer.slotScreenLocked( true );
+    timer.m_lockedSince = QDateTime::currentDateTime().addSecs( -m_intervals[TINY_BREAK_DURATION] );
+    timer.slotScreenLocked( false );
+    QCOMPARE( timer.m_state, RSITimer::TimerState::Monitoring );
+}
+
 #include "rsitimer_test.moc"
@@ -37,6 +37,12 @@ private slots:
     void skipBreak();
     void noPopupBreak();
     void regularBreaks();
+    void activityBudget();
+    void budgetDuringBreak();
+    void inhibitedBreak();
+    void inhibitedBudget();
+    void idleInhibitedBreak();
+    void lockedCredit();
 };
 
 #endif //RSIBREAK_RSITIMER_TEST_H
@@ -19,6 +19,22 @@
 
 #include "rsitimer_test.h"
 #include "rsitimercounter_test.h"
+#include "rsibreakschedules_test.h"
+#include "rsiactivitywindow_test.h"
+#include "imagebundle_test.h"
+#include "framebufferpool_test.h"
+#include "imagescaler_test.h"
+#include "imageblur_test.h"
+#include "dbusclient_test.h"
+#include "rsiconfig_test.h"
+#include "configwatcher_test.h"
+#include "progressicon_test.h"
+#include "rsiinputactivity_test.h"
+#include "rsiidletimexsync_test.h"
+#include "rsiidletimewayland_test.h"
+#include "rsiidletimeevdev_test.h"
+#include "inhibitionwatcher_test.h"
+#include "rsiappusage_test.h"
 
 int main( int argc, char *argv[] )
 {
@@ -27,6 +43,22 @@ int main( int argc, char *argv[] )
     std::vector<std::unique_ptr<QObject>> tests;
     tests.emplace_back( new RSITimerCounterTest() );
     tests.emplace_back( new RSITimerTest() );
+    tests.emplace_back( new RSIBreakSchedulesTest() );
+    tests.emplace_back( new RSIActivityWindowTest() );
+    tests.emplace_back( new ImageBundleTest() );
+    tests.emplace_back( new FrameBufferPoolTest() );
+    tests.emplace_back( new ImageScalerTest() );
+    tests.emplace_back( new ImageBlurTest() );
+    tests.emplace_back( new DBusClientTest() );
+    tests.emplace_back( new RSIConfigTest() );
+    tests.emplace_back( new ConfigWatcherTest() );
+    tests.emplace_back( new ProgressIconTest() );
+    tests.emplace_back( new RSIInputActivityTest() );
+    tests.emplace_back( new RSIIdleTimeXSyncTest() );
+    tests.emplace_back( new RSIIdleTimeWaylandTest() );
+    tests.emplace_back( new RSIIdleTimeEvdevTest() );
+    tests.emplace_back( new InhibitionWatcherTest() );
+    tests.emplace_back( new RSIAppUsageTest() );
 
     int status = 0;
     for ( auto& test : tests ) {